@@ -0,0 +1,354 @@
+/**
+ * Micro-benchmarks for every effect: ns/sample and samples/sec across a few parameter configurations,
+ * through `processSample()` and `processBlock()`, in float and double, for one channel and for several.
+ *
+ * Each measurement is repeated and reported as percentiles, so a regression in a hot path shows up as a shift
+ * in the median instead of getting lost in the noise of a single run.
+ *
+ *     bench_effects [--filter=<text>] [--reps=<n>] [--quick] [--json[=<file>]]
+ *
+ *     --filter  only run benchmarks whose name contains <text>, e.g. --filter=Reverb or --filter=double
+ *     --reps    repetitions per measurement (default 25)
+ *     --quick   3 short repetitions, for checking that everything still runs
+ *     --json    print results as JSON (or write them to <file> and print the table as usual)
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "../include/gimmel.hpp"
+
+namespace {
+    const int sampleRate = 48000;
+    const int blockSize = 256;
+    const int multiChannels = 8;
+
+    struct Options {
+        std::string filter;
+        int reps = 25;
+        int samplesPerRep = 16384; // per channel
+        bool json = false;
+        std::string jsonPath; // empty for stdout
+    };
+
+    struct Result {
+        std::string name; // effect/config/type/path/channels
+        std::string effect, config, type, path;
+        int channels;
+        double min, p50, p90, p99, mean; // ns per sample per channel
+    };
+
+    /**
+     * @brief Percentile of sorted values (nearest rank)
+     */
+    double percentile(const std::vector<double>& sorted, double p) {
+        size_t rank = (size_t)(p / 100.0 * sorted.size() + 0.999999);
+        rank = (rank < 1) ? 1 : (rank > sorted.size()) ? sorted.size() : rank;
+        return sorted[rank - 1];
+    }
+
+    /**
+     * @brief Deterministic white noise at -6dBFS, so every run processes the same input
+     */
+    template <typename T>
+    void fillNoise(T* x, int numSamples, unsigned int seed) {
+        for (int i = 0; i < numSamples; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            x[i] = static_cast<T>((seed >> 8) * (1.0 / 16777216.0) - 0.5);
+        }
+    }
+
+    template <typename E, typename T>
+    void processSamples(E& effect, const T* in, T* out, int numSamples) {
+        for (int i = 0; i < numSamples; i++) {
+            out[i] = effect.processSample(in[i]);
+        }
+    }
+
+    class Runner {
+    private:
+        Options options;
+        std::vector<Result> results;
+
+        /**
+         * @brief Times `reps` runs of `samplesPerRep` samples through every channel's effect, one block at a time
+         */
+        template <typename E, typename T, typename Make>
+        void measure(const char* effect, const char* config, const char* type, bool block, int channels, Make make) {
+            std::string name = std::string(effect) + "/" + config + "/" + type + "/" + (block ? "block" : "sample") + "/" + std::to_string(channels) + "ch";
+            if (name.find(this->options.filter) == std::string::npos) {
+                return;
+            }
+
+            std::vector<std::unique_ptr<E>> effects;
+            for (int c = 0; c < channels; c++) {
+                effects.emplace_back(make());
+            }
+            int n = this->options.samplesPerRep;
+            std::vector<T> in(n * channels), out(n * channels);
+            for (int c = 0; c < channels; c++) {
+                fillNoise(in.data() + c * n, n, 12345u + c);
+            }
+
+            auto run = [&]() {
+                for (int start = 0; start < n; start += blockSize) {
+                    int len = std::min(blockSize, n - start);
+                    for (int c = 0; c < channels; c++) { // like a host: every channel's block, then the next block
+                        const T* x = in.data() + c * n + start;
+                        T* y = out.data() + c * n + start;
+                        if (block) {
+                            giml::processEffect(*effects[c], x, y, len, giml::hasProcessBlock<E, T>{});
+                        }
+                        else {
+                            processSamples(*effects[c], x, y, len);
+                        }
+                    }
+                }
+            };
+
+            run(); // warm up caches, buffers and branch predictors
+            std::vector<double> ns;
+            for (int r = 0; r < this->options.reps; r++) {
+                auto begin = std::chrono::steady_clock::now();
+                run();
+                auto end = std::chrono::steady_clock::now();
+                ns.push_back(std::chrono::duration<double, std::nano>(end - begin).count() / ((double)n * channels));
+            }
+            volatile T sink = out[n * channels - 1]; // keep the output alive
+            (void)sink;
+
+            std::sort(ns.begin(), ns.end());
+            double sum = 0;
+            for (double v : ns) {
+                sum += v;
+            }
+            this->results.push_back(Result{ name, effect, config, type, block ? "block" : "sample", channels,
+                ns.front(), percentile(ns, 50), percentile(ns, 90), percentile(ns, 99), sum / ns.size() });
+            if (!this->options.json || !this->options.jsonPath.empty()) {
+                const Result& r = this->results.back();
+                printf("%-52s %9.2f %9.2f %9.2f %9.2f %12.0f\n", r.name.c_str(), r.min, r.p50, r.p90, r.p99, 1e9 / r.p50);
+                fflush(stdout);
+            }
+        }
+
+    public:
+        Runner(const Options& options) : options(options) {}
+
+        /**
+         * @brief Benchmarks one configuration of an effect through both paths, mono and multichannel
+         * @param make returns a new, configured and enabled effect
+         */
+        template <typename E, typename T, typename Make>
+        void bench(const char* effect, const char* config, Make make) {
+            const char* type = std::is_same<T, float>::value ? "float" : "double";
+            for (int channels : { 1, multiChannels }) {
+                this->measure<E, T>(effect, config, type, false, channels, make);
+                if (giml::hasProcessBlock<E, T>::value) { // effects without `processBlock()` only have the sample path
+                    this->measure<E, T>(effect, config, type, true, channels, make);
+                }
+            }
+        }
+
+        void printHeader() {
+            if (!this->options.json || !this->options.jsonPath.empty()) {
+                printf("%-52s %9s %9s %9s %9s %12s\n", "benchmark (ns/sample)", "min", "p50", "p90", "p99", "samples/s");
+            }
+        }
+
+        bool writeJSON() {
+            FILE* f = this->options.jsonPath.empty() ? stdout : fopen(this->options.jsonPath.c_str(), "w");
+            if (!f) {
+                printf("Couldn't open %s\n", this->options.jsonPath.c_str());
+                return false;
+            }
+            fprintf(f, "{\n  \"sampleRate\": %d,\n  \"blockSize\": %d,\n  \"samplesPerRep\": %d,\n  \"reps\": %d,\n  \"results\": [\n",
+                sampleRate, blockSize, this->options.samplesPerRep, this->options.reps);
+            for (size_t i = 0; i < this->results.size(); i++) {
+                const Result& r = this->results[i];
+                fprintf(f, "    {\"name\": \"%s\", \"effect\": \"%s\", \"config\": \"%s\", \"type\": \"%s\", \"path\": \"%s\", \"channels\": %d, "
+                    "\"nsPerSample\": {\"min\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"mean\": %.3f}, \"samplesPerSecond\": %.0f}%s\n",
+                    r.name.c_str(), r.effect.c_str(), r.config.c_str(), r.type.c_str(), r.path.c_str(), r.channels,
+                    r.min, r.p50, r.p90, r.p99, r.mean, 1e9 / r.p50, (i + 1 < this->results.size()) ? "," : "");
+            }
+            fprintf(f, "  ]\n}\n");
+            if (f != stdout) {
+                fclose(f);
+            }
+            return true;
+        }
+
+        size_t getNumResults() const {
+            return this->results.size();
+        }
+    };
+
+    template <typename E, typename... Args>
+    E* enabled(Args... args) {
+        E* e = new E(args...);
+        e->enable();
+        return e;
+    }
+
+    // Phaser is float-only (its filters are `Biquad<float>`)
+    template <typename T>
+    void benchPhaser(Runner& runner, std::true_type) {
+        runner.bench<giml::Phaser<T>, T>("Phaser", "default", [] {
+            return enabled<giml::Phaser<T>>(sampleRate);
+        });
+    }
+    template <typename T>
+    void benchPhaser(Runner&, std::false_type) {}
+
+    template <typename T>
+    void benchAll(Runner& runner) {
+        runner.bench<giml::Biquad<T>, T>("Biquad", "LPF Butterworth", [] {
+            auto e = enabled<giml::Biquad<T>>(sampleRate);
+            e->setType(giml::Biquad<T>::BiquadUseCase::LPF_Butterworth);
+            e->setParams(2000.f);
+            return e;
+        });
+        runner.bench<giml::Chorus<T>, T>("Chorus", "1 voice", [] {
+            return enabled<giml::Chorus<T>>(sampleRate);
+        });
+        runner.bench<giml::Chorus<T>, T>("Chorus", "8 voice ensemble", [] {
+            return enabled<giml::Chorus<T>>(sampleRate, 150.f, 8);
+        });
+        runner.bench<giml::Compressor<T>, T>("Compressor", "4:1 at -20dB", [] {
+            auto e = enabled<giml::Compressor<T>>(sampleRate);
+            e->setThresh(-20.f);
+            e->setRatio(4.f);
+            return e;
+        });
+        runner.bench<giml::ConvolutionReverb<T>, T>("ConvolutionReverb", "0.5s IR", [] {
+            auto e = enabled<giml::ConvolutionReverb<T>>(sampleRate);
+            std::vector<T> ir(sampleRate / 2);
+            fillNoise(ir.data(), (int)ir.size(), 777u);
+            for (size_t i = 0; i < ir.size(); i++) {
+                ir[i] *= static_cast<T>(::exp(-6.9 * i / ir.size())); // decays 60dB
+            }
+            e->setImpulseResponse(ir.data(), ir.size());
+            return e;
+        });
+        runner.bench<giml::Delay<T>, T>("Delay", "300ms feedback 0.5", [] {
+            auto e = enabled<giml::Delay<T>>(sampleRate);
+            e->setDelayTime(300);
+            e->setFeedback(0.5);
+            return e;
+        });
+        runner.bench<giml::Delay<T>, T>("Delay", "crossfade smoothing", [] {
+            auto e = enabled<giml::Delay<T>>(sampleRate);
+            e->setDelayTime(300);
+            e->setFeedback(0.5);
+            e->setSmoothing(giml::Delay<T>::SmoothingMode::CROSSFADE);
+            return e;
+        });
+        runner.bench<giml::Detune<T>, T>("Detune", "default", [] {
+            return enabled<giml::Detune<T>>(sampleRate);
+        });
+        runner.bench<giml::FDNReverb<T>, T>("FDNReverb", "8 lines", [] {
+            auto e = enabled<giml::FDNReverb<T>>(sampleRate, 8);
+            e->setParams(0.03f, 0.5f, 0.3f, 20.f);
+            return e;
+        });
+        runner.bench<giml::FDNReverb<T>, T>("FDNReverb", "16 lines", [] {
+            auto e = enabled<giml::FDNReverb<T>>(sampleRate, 16);
+            e->setParams(0.03f, 0.5f, 0.3f, 20.f);
+            return e;
+        });
+        runner.bench<giml::Harmonizer<T>, T>("Harmonizer", "4 voices", [] {
+            auto e = enabled<giml::Harmonizer<T>>(sampleRate, 4);
+            for (int v = 0; v < 4; v++) {
+                e->setSemitones(v, 3.f * (v + 1));
+            }
+            return e;
+        });
+        runner.bench<giml::MultiTapDelay<T>, T>("MultiTapDelay", "4 taps", [] {
+            auto e = enabled<giml::MultiTapDelay<T>>(sampleRate);
+            e->setNumTaps(4);
+            for (int t = 0; t < 4; t++) {
+                e->setTapTime(t, 100.f * (t + 1));
+            }
+            return e;
+        });
+        benchPhaser<T>(runner, std::is_same<T, float>{});
+        runner.bench<giml::PitchShifter<T>, T>("PitchShifter", "low latency", [] {
+            auto e = enabled<giml::PitchShifter<T>>(sampleRate, giml::PitchShifter<T>::Mode::LOW_LATENCY);
+            e->setSemitones(7.f);
+            return e;
+        });
+        runner.bench<giml::Reverb<T>, T>("Reverb", "small room", [] {
+            auto e = enabled<giml::Reverb<T>>(sampleRate);
+            e->setParams(0.02f, 0.5f, 0.3f, 5.f);
+            return e;
+        });
+        runner.bench<giml::Reverb<T>, T>("Reverb", "hall", [] {
+            auto e = enabled<giml::Reverb<T>>(sampleRate);
+            e->setParams(0.05f, 0.7f, 0.5f, 60.f);
+            return e;
+        });
+        runner.bench<giml::Saturation<T>, T>("Saturation", "no oversampling", [] {
+            auto e = enabled<giml::Saturation<T>>(sampleRate);
+            e->setDrive(4.f);
+            return e;
+        });
+        runner.bench<giml::Saturation<T>, T>("Saturation", "4x oversampling", [] {
+            auto e = enabled<giml::Saturation<T>>(sampleRate, 4);
+            e->setDrive(4.f);
+            return e;
+        });
+        runner.bench<giml::Tremolo<T>, T>("Tremolo", "default", [] {
+            return enabled<giml::Tremolo<T>>(sampleRate);
+        });
+    }
+
+    bool startsWith(const char* arg, const char* prefix) {
+        return ::strncmp(arg, prefix, ::strlen(prefix)) == 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (startsWith(arg, "--filter=")) {
+            options.filter = arg + 9;
+        }
+        else if (startsWith(arg, "--reps=")) {
+            options.reps = std::max(1, atoi(arg + 7));
+        }
+        else if (!::strcmp(arg, "--quick")) {
+            options.reps = 3;
+            options.samplesPerRep = 2048;
+        }
+        else if (!::strcmp(arg, "--json")) {
+            options.json = true;
+        }
+        else if (startsWith(arg, "--json=")) {
+            options.json = true;
+            options.jsonPath = arg + 7;
+        }
+        else {
+            printf("usage: %s [--filter=<text>] [--reps=<n>] [--quick] [--json[=<file>]]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    giml::ScopedFlushDenormals noDenormals; // measure the effects, not denormal stalls (see bench/denormals.cpp)
+    Runner runner{ options };
+    runner.printHeader();
+    benchAll<float>(runner);
+    benchAll<double>(runner);
+
+    if (runner.getNumResults() == 0) {
+        printf("No benchmarks match \"%s\"\n", options.filter.c_str());
+        return 1;
+    }
+    if (options.json && !runner.writeJSON()) {
+        return 1;
+    }
+    return 0;
+}
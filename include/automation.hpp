@@ -0,0 +1,192 @@
+#ifndef GIML_AUTOMATION_HPP
+#define GIML_AUTOMATION_HPP
+#include <type_traits>
+#include <utility>
+#include "utility.hpp"
+namespace giml {
+    /**
+     * @brief Checks whether an effect has `processBlock(const T* in, T* out, int numSamples)`
+     */
+    template <typename E, typename T, typename = void>
+    struct hasProcessBlock : std::false_type {};
+    template <typename E, typename T>
+    struct hasProcessBlock<E, T, decltype(void(std::declval<E&>().processBlock((const T*)nullptr, (T*)nullptr, 0)))> : std::true_type {};
+
+    /**
+     * @brief Runs `numSamples` samples through an effect, using its `processBlock()` if it has one
+     */
+    template <typename E, typename T>
+    inline void processEffect(E& effect, const T* in, T* out, int numSamples, std::true_type) {
+        effect.processBlock(in, out, numSamples);
+    }
+    template <typename E, typename T>
+    inline void processEffect(E& effect, const T* in, T* out, int numSamples, std::false_type) {
+        for (int n = 0; n < numSamples; n++) {
+            out[n] = effect.processSample(in[n]);
+        }
+    }
+
+    /**
+     * @brief A timeline of parameter changes for one effect, applied at exact sample positions
+     *
+     * Events are added ahead of time with the sample they should take effect on. `process()` then runs the effect
+     * over a block, splitting it wherever an event falls: each run between two events goes through the effect's
+     * `processBlock()` (or a `processSample()` loop for effects without one), and the events are applied in
+     * between. A long block with no events is processed in one call, and every change still lands on its exact sample.
+     *
+     * ```
+     * giml::AutomationLane<giml::Saturation<float>> lane;
+     * lane.addEvent(0, &giml::Saturation<float>::setDrive, 1.f);
+     * lane.addEvent(48000, &giml::Saturation<float>::setDrive, 8.f); // one second in at 48kHz
+     * lane.process(saturation, in, out, numSamples); // once per block, in order
+     * ```
+     *
+     * Setters with more than one argument (such as `Reverb::setParams()`) can be automated with a function
+     * (or a lambda without captures) that takes the effect and the value:
+     * `lane.addEvent(t, [](giml::Reverb<float>& r, float length) { r.setParams(0.03f, 0.5f, 0.3f, length); }, 20.f);`
+     *
+     * `addEvent()` allocates, so build the timeline before rendering (or keep it off the audio thread).
+     *
+     * @tparam E effect type
+     * @tparam V setter argument type
+     */
+    template <typename E, typename V = float>
+    class AutomationLane {
+    public:
+        using Setter = void (E::*)(V);
+        using Action = void (*)(E&, V);
+
+    private:
+        struct Event {
+            long long time; // in samples from the start of the timeline
+            Setter setter;
+            Action action; // used when `setter` is `nullptr`
+            V value;
+        };
+
+        DynamicArray<Event> events; // sorted by time, ties kept in the order they were added
+        size_t nextEvent = 0; // first event that hasn't been applied yet
+        long long position = 0; // sample that the next `process()` call starts on
+
+        void insert(const Event& e) {
+            this->events.pushBack(e);
+            size_t i = this->events.size() - 1;
+            while (i > 0 && this->events[i - 1].time > e.time) { // insertion sort, events usually arrive in order
+                this->events[i] = this->events[i - 1];
+                i--;
+            }
+            this->events[i] = e;
+            if (i < this->nextEvent) { // added before the playhead, apply it at the start of the next block
+                this->nextEvent = i;
+            }
+        }
+
+        void apply(E& effect, const Event& e) {
+            if (e.setter) {
+                (effect.*(e.setter))(e.value);
+            }
+            else {
+                e.action(effect, e.value);
+            }
+        }
+
+    public:
+        /**
+         * @brief Adds a setter call to the timeline
+         * @param sampleTime sample the change takes effect on (see `giml::millisToSamples()`)
+         * @param setter pointer to the effect's setter, e.g. `&giml::Delay<float>::setFeedback`
+         * @param value argument for the setter
+         */
+        void addEvent(long long sampleTime, Setter setter, V value) {
+            this->insert(Event{ sampleTime, setter, nullptr, value });
+        }
+
+        /**
+         * @brief Adds a function call to the timeline
+         * @param sampleTime sample the change takes effect on
+         * @param action function called with the effect and `value`
+         * @param value argument for `action`
+         */
+        void addEvent(long long sampleTime, Action action, V value) {
+            this->insert(Event{ sampleTime, nullptr, action, value });
+        }
+
+        /**
+         * @brief Removes every event (the playhead stays where it is)
+         */
+        void clear() {
+            while (this->events.size() > 0) {
+                this->events.popBack();
+            }
+            this->nextEvent = 0;
+        }
+
+        size_t getNumEvents() {
+            return this->events.size();
+        }
+
+        /**
+         * @brief Moves the playhead, e.g. to render the timeline again from the start.
+         * Events before the new position aren't applied
+         * @param sampleTime sample that the next `process()` call starts on
+         */
+        void setPosition(long long sampleTime) {
+            this->position = sampleTime;
+            this->nextEvent = 0;
+            while (this->nextEvent < this->events.size() && this->events[this->nextEvent].time < sampleTime) {
+                this->nextEvent++;
+            }
+        }
+
+        long long getPosition() const {
+            return this->position;
+        }
+
+        /**
+         * @brief Applies every event due at or before the playhead and returns how many samples can be processed
+         * before the next one. Use this to drive effects that `process()` doesn't fit, such as stereo ones
+         * @param effect effect to update
+         * @param maxSamples samples left in the block
+         * @return samples until the next event (at most `maxSamples`), which the caller must then `advance()` by
+         */
+        int applyEvents(E& effect, int maxSamples) {
+            while (this->nextEvent < this->events.size() && this->events[this->nextEvent].time <= this->position) {
+                this->apply(effect, this->events[this->nextEvent++]);
+            }
+            if (this->nextEvent < this->events.size()) {
+                long long untilNext = this->events[this->nextEvent].time - this->position;
+                if (untilNext < maxSamples) {
+                    return static_cast<int>(untilNext);
+                }
+            }
+            return maxSamples;
+        }
+
+        /**
+         * @brief Moves the playhead forward after processing samples yourself (see `applyEvents()`)
+         * @param numSamples samples processed
+         */
+        void advance(int numSamples) {
+            this->position += numSamples;
+        }
+
+        /**
+         * @brief Processes a block through `effect`, applying every event on its exact sample
+         * @param effect effect to update and process
+         * @param in input samples
+         * @param out output samples (may be the same as `in`)
+         * @param numSamples number of samples
+         */
+        template <typename T>
+        void process(E& effect, const T* in, T* out, int numSamples) {
+            int done = 0;
+            while (done < numSamples) {
+                int segment = this->applyEvents(effect, numSamples - done);
+                giml::processEffect(effect, in + done, out + done, segment, giml::hasProcessBlock<E, T>{});
+                this->advance(segment);
+                done += segment;
+            }
+        }
+    };
+}
+#endif
@@ -3,6 +3,259 @@
 #include <math.h>
 #include "utility.hpp"
 namespace giml {
+    /**
+     * @brief The five coefficients of a normalized biquad difference equation:
+     * `y[n] = a0 x[n] + a1 x[n-1] + a2 x[n-2] - b1 y[n-1] - b2 y[n-2]`
+     */
+    template <typename T>
+    struct BiquadCoefficients {
+        T a0, a1, a2, //Numerator coefficients
+            b1, b2;   //Denominator coefficients
+    };
+
+    /**
+     * @brief Math used by `giml::BiquadDesign` when coefficients are calculated at runtime
+     */
+    struct BiquadRuntimeMath {
+        static float sin(float x) { return ::sinf(x); }
+        static float cos(float x) { return ::cosf(x); }
+        static float tan(float x) { return ::tanf(x); }
+        static float sqrt(float x) { return ::sqrtf(x); }
+        static float dBtoA(float dBVal) { return giml::dBtoA(dBVal); }
+    };
+
+    /**
+     * @brief Math used by `giml::BiquadDesign` when coefficients are calculated at compile time
+     */
+    struct BiquadConstexprMath {
+        static constexpr float sin(float x) { return giml::constexprSin(x); }
+        static constexpr float cos(float x) { return giml::constexprCos(x); }
+        static constexpr float tan(float x) { return giml::constexprTan(x); }
+        static constexpr float sqrt(float x) { return giml::constexprSqrt(x); }
+        static constexpr float dBtoA(float dBVal) { return giml::constexprDBtoA(dBVal); }
+    };
+
+    /**
+     * @brief Coefficient design formulas for every `giml::Biquad` use case.
+     * 
+     * The formulas are written once and shared: `giml::Biquad` uses them at runtime with `BiquadRuntimeMath`,
+     * while `giml::FixedBiquad` evaluates them at compile time with `BiquadConstexprMath`
+     * 
+     * @tparam T floating-point type of the coefficients
+     * @tparam Math either `BiquadRuntimeMath` or `BiquadConstexprMath`
+     */
+    template <typename T, typename Math = BiquadRuntimeMath>
+    struct BiquadDesign {
+        static constexpr BiquadCoefficients<T> LPF_1st(float cutoffFrequency, int sampleRate) {
+            float cutoffAngle = M_2PI * cutoffFrequency / sampleRate;
+            float gamma = Math::cos(cutoffAngle) / (1 + Math::sin(cutoffAngle));
+            T a0 = (1 - gamma) / 2;
+            return BiquadCoefficients<T>{ a0, a0, 0, -gamma, 0 };
+        }
+
+        static constexpr BiquadCoefficients<T> HPF_1st(float cutoffFrequency, int sampleRate) {
+            float cutoffAngle = M_2PI * cutoffFrequency / sampleRate;
+            float gamma = Math::cos(cutoffAngle) / (1 + Math::sin(cutoffAngle));
+            T a0 = (1 + gamma) / 2;
+            return BiquadCoefficients<T>{ a0, -a0, 0, -gamma, 0 };
+        }
+
+        static constexpr BiquadCoefficients<T> LPF_2nd(float cutoffFrequency, float Q, int sampleRate) {
+            float cutoffAngle = M_2PI * cutoffFrequency / sampleRate;
+            float d = Math::sin(cutoffAngle) / (2 * Q);
+            float Beta = (1 + (1 - d) / (1 + d)) / 2;
+            float gamma = Beta * Math::cos(cutoffAngle);
+
+            T a0 = (Beta - gamma) / 2;
+            return BiquadCoefficients<T>{ a0, Beta - gamma, a0, -2 * gamma, 2 * Beta - 1 };
+        }
+
+        static constexpr BiquadCoefficients<T> HPF_2nd(float cutoffFrequency, float Q, int sampleRate) {
+            float cutoffAngle = M_2PI * cutoffFrequency / sampleRate;
+            float d = Math::sin(cutoffAngle) / (2 * Q);
+            float Beta = (1 + (1 - d) / (1 + d)) / 2;
+            float gamma = Beta * Math::cos(cutoffAngle);
+
+            T a0 = (Beta + gamma) / 2;
+            return BiquadCoefficients<T>{ a0, -(Beta + gamma), a0, -2 * gamma, 2 * Beta - 1 };
+        }
+
+        static constexpr BiquadCoefficients<T> BPF(float cutoffFrequency, float Q, int sampleRate) {
+            float K = Math::tan(M_PI * cutoffFrequency / sampleRate);
+            float KSquared = K * K;
+            float delta = KSquared * Q + K + Q;
+
+            T a0 = K / delta;
+            return BiquadCoefficients<T>{ a0, 0, -a0, 2 * Q * (KSquared - 1) / delta, (KSquared - K + Q) / delta };
+        }
+
+        static constexpr BiquadCoefficients<T> BSF(float cutoffFrequency, float Q, int sampleRate) {
+            float K = Math::tan(M_PI * cutoffFrequency / sampleRate);
+            float KSquared = K * K;
+            float delta = KSquared * Q + K + Q;
+
+            T a0 = Q * (KSquared + 1) / delta;
+            T a1 = 2 * Q * (KSquared - 1) / delta;
+            return BiquadCoefficients<T>{ a0, a1, a0, a1, (KSquared * Q - K + Q) / delta };
+        }
+
+        static constexpr BiquadCoefficients<T> LPF_Butterworth(float cutoffFrequency, int sampleRate) {
+            //Q is fixed to sqrt(2) to avoid resonance
+            float C = 1 / Math::tan(M_PI * cutoffFrequency / sampleRate);
+            float CSquared = C * C;
+
+            T a0 = 1 / (1 + M_SQRT2 * C + CSquared);
+            T b2 = a0 * (1 - M_SQRT2 * C + CSquared);
+            return BiquadCoefficients<T>{ a0, 2 * a0, a0, 2 * a0 * (1 - CSquared), b2 };
+        }
+
+        static constexpr BiquadCoefficients<T> HPF_Butterworth(float cutoffFrequency, int sampleRate) {
+            //Q is fixed to sqrt(2) to avoid resonance
+            float C = Math::tan(M_PI * cutoffFrequency / sampleRate);
+            float CSquared = C * C;
+
+            T a0 = 1 / (1 + M_SQRT2 * C + CSquared);
+            T b2 = a0 * (1 - M_SQRT2 * C + CSquared);
+            return BiquadCoefficients<T>{ a0, -2 * a0, a0, 2 * a0 * (CSquared - 1), b2 };
+        }
+
+        static constexpr BiquadCoefficients<T> BPF_Butterworth(float cutoffFrequency, float Q, int sampleRate) {
+            float BW = cutoffFrequency / Q; //Bandwidth
+            float C = 1 / Math::tan(M_PI * cutoffFrequency * BW / sampleRate);
+            float D = 2 * Math::tan(M_2PI * cutoffFrequency / sampleRate);
+
+            T a0 = 1 / (1 + C);
+            return BiquadCoefficients<T>{ a0, 0, -a0, -a0 * C * D, a0 * (C - 1) };
+        }
+
+        static constexpr BiquadCoefficients<T> BSF_Butterworth(float cutoffFrequency, float Q, int sampleRate) {
+            float BW = cutoffFrequency / Q; //Bandwidth
+            float C = Math::tan(M_PI * cutoffFrequency * BW / sampleRate);
+            float D = 2 * Math::tan(M_2PI * cutoffFrequency / sampleRate);
+
+            T a0 = 1 / (1 + C);
+            return BiquadCoefficients<T>{ a0, 0, -a0, -a0 * C * D, a0 * (C - 1) };
+        }
+
+        static constexpr BiquadCoefficients<T> APF_1st(float cutoffFrequency, int sampleRate) {
+            float t = Math::tan(M_PI * cutoffFrequency / sampleRate);
+            float alpha = (t - 1) / (t + 1);
+            return BiquadCoefficients<T>{ alpha, 1, 0, alpha, 0 };
+        }
+
+        static constexpr BiquadCoefficients<T> APF_2nd(float cutoffFrequency, float Q, int sampleRate) {
+            float cutoffAngle = M_2PI * cutoffFrequency / sampleRate;
+            float alpha = Math::sin(cutoffAngle) / (2 * Q);
+
+            T a0 = (1 - alpha) / (1 + alpha);
+            T a1 = -2 * Math::cos(cutoffAngle) / (1 + alpha);
+            return BiquadCoefficients<T>{ a0, a1, 1, a1, a0 };
+
+            /*float BW = cutoffFrequency / Q;
+            float t = ::tanf(M_PI * BW / this->sampleRate);
+            float alpha = (t - 1) / (t + 1);
+            float Beta = -::cosf(M_2PI * cutoffFrequency / this->sampleRate);
+            this->a0 = -alpha;
+            this->a1 = Beta * (1 - alpha);
+            this->a2 = 1;
+
+            this->b1 = Beta * (1 - alpha);
+            this->b2 = -alpha;*/
+        }
+
+        static constexpr BiquadCoefficients<T> LSF(float cutoffFrequency, float Q, float gainDB, int sampleRate) {
+            float cutoffAngle = M_2PI * cutoffFrequency / sampleRate;
+            float A = Math::dBtoA(gainDB);
+
+            float cosss = Math::cos(cutoffAngle);
+            //Conversion between Q and shelf steepness (S)
+            //float gamma = ::sinf(cutoffAngle) * ::sqrtf((A * A + 1) * ((1 / (Q * Q) - 2) / (A + 1 / A)) + 2 * A);
+            float gamma = Math::sin(cutoffAngle) * Math::sqrt(A) / Q;
+            float alpha = (A + 1) * cosss;
+            float beta = (A - 1) * cosss;
+            float c = (A + 1) + beta + gamma;
+
+            return BiquadCoefficients<T>{
+                A * (A + 1 - beta + gamma) / c,
+                2 * A * (A - 1 - alpha) / c,
+                A * (A + 1 - beta - gamma) / c,
+                -2 * (A - 1 + alpha) / c,
+                (A + 1 + beta - gamma) / c
+            };
+
+            /*float delta = 4 * ::tanf(cutoffFrequency / 2) / (1 + A);
+            float gamma = (1 - delta) / (1 + delta);
+
+            this->a0 = (1 - gamma) / 2;
+            this->a1 = this->a0;
+            this->a2 = 0;
+
+            this->b1 = -gamma;
+            this->b2 = 0;
+
+            this->dry = 1;
+            this->wet = A - 1;*/
+        }
+
+        static constexpr BiquadCoefficients<T> HSF(float cutoffFrequency, float Q, float gainDB, int sampleRate) {
+            float cutoffAngle = M_2PI * cutoffFrequency / sampleRate;
+            float A = Math::dBtoA(gainDB);
+
+            float cosss = Math::cos(cutoffAngle);
+            //Conversion between Q and shelf steepness (S)
+            //float gamma = ::sinf(cutoffAngle) * ::sqrtf((A * A + 1) * ((1 / (Q * Q) - 2) / (A + 1 / A)) + 2 * A);
+            float gamma = Math::sin(cutoffAngle) * Math::sqrt(A) / Q;
+            float alpha = (A + 1) * cosss;
+            float beta = (A - 1) * cosss;
+            float c = (A + 1) - beta + gamma;
+
+            return BiquadCoefficients<T>{
+                A * (A + 1 + beta + gamma) / c,
+                -2 * A * (A - 1 + alpha) / c,
+                A * (A + 1 + beta - gamma) / c,
+                2 * (A - 1 - alpha) / c,
+                (A + 1 - beta - gamma) / c
+            };
+
+            //float delta = (1 + multiplier) * ::tanf(cutoffFrequency / 2) / 4;
+            //float gamma = (1 - delta) / (1 + delta);
+
+            //this->a0 = (1 + gamma) / 2;
+            //this->a1 = -this->a0;
+            //this->a2 = 0;
+
+            //this->b1 = -gamma;
+            //this->b2 = 0;
+
+            //this->dry = 1;
+            //this->wet = multiplier - 1;
+        }
+
+        static constexpr BiquadCoefficients<T> PEQ_constQ(float centerFrequency, float Q, float gainDB, int sampleRate) {
+            float K = Math::tan(M_PI * centerFrequency / sampleRate);
+            float KSquared = K * K;
+            float vol = Math::dBtoA(gainDB);
+
+            float d = 1 + K / Q + KSquared;
+            float e = 1 + K / (vol * Q) + KSquared;
+
+            float alpha = 1 + vol * K / Q + KSquared;
+            float Beta = 2 * (KSquared - 1);
+            float gamma = 1 - vol * K / Q + KSquared;
+            float delta = 1 - K / Q + KSquared;
+            float nu = 1 - K / (vol * Q) + KSquared;
+
+            if (gainDB >= 0) {
+                //Then we are boosting this range
+                return BiquadCoefficients<T>{ alpha / d, Beta / d, gamma / d, Beta / d, delta / d };
+            }
+            else {
+                //We are cutting this range
+                return BiquadCoefficients<T>{ d / e, Beta / e, delta / e, Beta / e, nu / e };
+            }
+        }
+    };
+
     template <typename T>
     class Biquad : public Effect<T> {
     public:
@@ -65,6 +318,8 @@ namespace giml {
             this->cutoffFrequency = b.cutoffFrequency;
             this->Q = b.Q;
             this->gainDB = b.gainDB;
+
+            this->kernelDirty = true;
         }
         // Copy assignment operator
         Biquad<T>& operator=(const Biquad<T>& b) {
@@ -88,6 +343,8 @@ namespace giml {
             this->Q = b.Q;
             this->gainDB = b.gainDB;
 
+            this->kernelDirty = true;
+
             return *this;
         }
         //TODO: Copy constructor + Copy assignment constructor
@@ -216,6 +473,73 @@ namespace giml {
 
             return returnVal;
         }
+
+        /**
+         * @brief Block version of `processSample()`. The recursion is unrolled `kernelSize` samples at a time
+         * (state-space/scan form): each group of outputs is a small matrix-vector product of the group's inputs 
+         * and the 4 state values, so the samples within a group are independent and fill SIMD lanes on a single channel.
+         * Use cases that `processSample()` does not implement fall back to the per-sample path
+         * 
+         * @param in input samples
+         * @param out output samples (may be the same array as `in`)
+         * @param numSamples number of samples to process
+         */
+        void processBlock(const T* in, T* out, int numSamples) {
+            switch (useCase) {
+            case BiquadUseCase::LPF_1st:
+            case BiquadUseCase::HPF_1st:
+            case BiquadUseCase::APF_1st:
+            case BiquadUseCase::LPF_2nd:
+            case BiquadUseCase::HPF_2nd:
+            case BiquadUseCase::LPF_Butterworth:
+            case BiquadUseCase::HPF_Butterworth:
+            case BiquadUseCase::APF_2nd:
+            case BiquadUseCase::LSF:
+            case BiquadUseCase::HSF:
+            case BiquadUseCase::PEQ_constQ:
+                break;
+            default:
+                for (int i = 0; i < numSamples; i++) {
+                    out[i] = this->processSample(in[i]);
+                }
+                return;
+            }
+
+            if (this->kernelDirty) {
+                this->updateKernel();
+            }
+
+            int i = 0;
+            for (; i + kernelSize <= numSamples; i += kernelSize) {
+                T x[kernelSize], y[kernelSize];
+                for (int k = 0; k < kernelSize; k++) {
+                    x[k] = in[i + k]; // copy in case `in` and `out` alias
+                }
+                for (int k = 0; k < kernelSize; k++) {
+                    y[k] = this->stateKernel[0][k] * prevX1 + this->stateKernel[1][k] * prevX2
+                        + this->stateKernel[2][k] * prevY1 + this->stateKernel[3][k] * prevY2;
+                }
+                for (int j = 0; j < kernelSize; j++) {
+                    for (int k = 0; k < kernelSize; k++) {
+                        y[k] += this->inputKernel[j][k] * x[j];
+                    }
+                }
+
+                //Back propagate inputs and outputs
+                prevX2 = x[kernelSize - 2];
+                prevX1 = x[kernelSize - 1];
+
+                prevY2 = y[kernelSize - 2];
+                prevY1 = y[kernelSize - 1];
+
+                for (int k = 0; k < kernelSize; k++) {
+                    out[i + k] = (this->enabled) ? y[k] : x[k];
+                }
+            }
+            for (; i < numSamples; i++) { // leftover samples
+                out[i] = this->processSample(in[i]);
+            }
+        }
     private:
         BiquadUseCase useCase = BiquadUseCase::PassThroughDefault;
 
@@ -229,18 +553,64 @@ namespace giml {
 
         float cutoffFrequency = 1000.f, Q = 0.707f, gainDB = 0.f;
 
+        //Block kernel (see `processBlock()`), 4 samples fill one SSE/NEON float register
+        static const int kernelSize = 4;
+        T inputKernel[kernelSize][kernelSize] = {}; // inputKernel[j][k]: contribution of x[n+j] to y[n+k]
+        T stateKernel[4][kernelSize] = {}; // contribution of prevX1, prevX2, prevY1, prevY2 to y[n+k]
+        bool kernelDirty = true; // recalculated lazily so per-sample `setParams()` calls (Phaser) stay cheap
+
+        /**
+         * @brief Runs the difference equation `kernelSize` steps from the given state with a single input at step 0
+         */
+        void runRecurrence(T x0, T x1, T x2, T y1, T y2, T* response) const {
+            for (int k = 0; k < kernelSize; k++) {
+                T y0 = a0 * x0 + a1 * x1 + a2 * x2 - b1 * y1 - b2 * y2;
+                response[k] = y0;
+                x2 = x1;
+                x1 = x0;
+                x0 = 0;
+                y2 = y1;
+                y1 = y0;
+            }
+        }
+
+        /**
+         * @brief Recalculates the block kernel from the impulse response and the responses to each state value
+         */
+        void updateKernel() {
+            T h[kernelSize];
+            this->runRecurrence(1, 0, 0, 0, 0, h);
+            for (int j = 0; j < kernelSize; j++) {
+                for (int k = 0; k < kernelSize; k++) {
+                    this->inputKernel[j][k] = (j > k) ? 0 : h[k - j];
+                }
+            }
+            this->runRecurrence(0, 1, 0, 0, 0, this->stateKernel[0]);
+            this->runRecurrence(0, 0, 1, 0, 0, this->stateKernel[1]);
+            this->runRecurrence(0, 0, 0, 1, 0, this->stateKernel[2]);
+            this->runRecurrence(0, 0, 0, 0, 1, this->stateKernel[3]);
+            this->kernelDirty = false;
+        }
+
+        /**
+         * @brief Copies a freshly designed set of coefficients into the filter
+         * @param c coefficients from `giml::BiquadDesign`
+         */
+        void setCoefficients(const BiquadCoefficients<T>& c) {
+            this->a0 = c.a0;
+            this->a1 = c.a1;
+            this->a2 = c.a2;
+            this->b1 = c.b1;
+            this->b2 = c.b2;
+            this->kernelDirty = true;
+        }
+
         void setParams__LPF_1st(float cutoffFrequency) {
             //Set type to low-pass if not already
             if (this->useCase != BiquadUseCase::LPF_1st) {
                 this->useCase = BiquadUseCase::LPF_1st;
             }
-            float cutoffAngle = M_2PI * cutoffFrequency / this->sampleRate;
-            float gamma = ::cosf(cutoffAngle) / (1 + ::sinf(cutoffAngle));
-            this->a0 = (1 - gamma) / 2;
-            this->a1 = this->a0;
-            this->a2 = 0;
-            this->b1 = -gamma;
-            this->b2 = 0;
+            this->setCoefficients(BiquadDesign<T>::LPF_1st(cutoffFrequency, this->sampleRate));
         }
 
         void setParams__HPF_1st(float cutoffFrequency) {
@@ -248,13 +618,7 @@ namespace giml {
             if (this->useCase != BiquadUseCase::HPF_1st) {
                 this->useCase = BiquadUseCase::HPF_1st;
             }
-            float cutoffAngle = M_2PI * cutoffFrequency / this->sampleRate;
-            float gamma = ::cosf(cutoffAngle) / (1 + ::sinf(cutoffAngle));
-            this->a0 = (1 + gamma) / 2;
-            this->a1 = -this->a0;
-            this->a2 = 0;
-            this->b1 = -gamma;
-            this->b2 = 0;
+            this->setCoefficients(BiquadDesign<T>::HPF_1st(cutoffFrequency, this->sampleRate));
         }
 
         void setParams__LPF_2nd(float cutoffFrequency, float Q) {
@@ -262,17 +626,7 @@ namespace giml {
             if (this->useCase != BiquadUseCase::LPF_2nd) {
                 this->useCase = BiquadUseCase::LPF_2nd;
             }
-            float cutoffAngle = M_2PI * cutoffFrequency / this->sampleRate;
-            float d = ::sinf(cutoffAngle) / (2 * Q);
-            float Beta = (1 + (1 - d) / (1 + d)) / 2;
-            float gamma = Beta * ::cosf(cutoffAngle);
-
-
-            this->a0 = (Beta - gamma) / 2;
-            this->a1 = Beta - gamma;
-            this->a2 = this->a0;
-            this->b1 = -2 * gamma;
-            this->b2 = 2 * Beta - 1;
+            this->setCoefficients(BiquadDesign<T>::LPF_2nd(cutoffFrequency, Q, this->sampleRate));
         }
 
         void setParams__HPF_2nd(float cutoffFrequency, float Q) {
@@ -280,17 +634,7 @@ namespace giml {
             if (this->useCase != BiquadUseCase::HPF_2nd) {
                 this->useCase = BiquadUseCase::HPF_2nd;
             }
-            float cutoffAngle = M_2PI * cutoffFrequency / this->sampleRate;
-            float d = ::sinf(cutoffAngle) / (2 * Q);
-            float Beta = (1 + (1 - d) / (1 + d)) / 2;
-            float gamma = Beta * ::cosf(cutoffAngle);
-
-
-            this->a0 = (Beta + gamma) / 2;
-            this->a1 = -(Beta + gamma);
-            this->a2 = this->a0;
-            this->b1 = -2 * gamma;
-            this->b2 = 2 * Beta - 1;
+            this->setCoefficients(BiquadDesign<T>::HPF_2nd(cutoffFrequency, Q, this->sampleRate));
         }
 
         void setParams__BPF(float cutoffFrequency, float Q) {
@@ -298,16 +642,7 @@ namespace giml {
             if (this->useCase != BiquadUseCase::BPF) {
                 this->useCase = BiquadUseCase::BPF;
             }
-            float K = ::tanf(M_PI * cutoffFrequency / this->sampleRate);
-            float KSquared = K * K;
-            float delta = KSquared * Q + K + Q;
-
-            this->a0 = K / delta;
-            this->a1 = 0;
-            this->a2 = -this->a0;
-
-            this->b1 = 2 * Q * (KSquared - 1) / delta;
-            this->b2 = (KSquared - K + Q) / delta;
+            this->setCoefficients(BiquadDesign<T>::BPF(cutoffFrequency, Q, this->sampleRate));
         }
 
         void setParams__BSF(float cutoffFrequency, float Q) {
@@ -315,16 +650,7 @@ namespace giml {
             if (this->useCase != BiquadUseCase::BSF) {
                 this->useCase = BiquadUseCase::BSF;
             }
-            float K = ::tanf(M_PI * cutoffFrequency / this->sampleRate);
-            float KSquared = K * K;
-            float delta = KSquared * Q + K + Q;
-
-            this->a0 = Q * (KSquared + 1) / delta;
-            this->a1 = 2 * Q * (KSquared - 1) / delta;
-            this->a2 = this->a0;
-
-            this->b1 = this->a1;
-            this->b2 = (KSquared * Q - K + Q) / delta;
+            this->setCoefficients(BiquadDesign<T>::BSF(cutoffFrequency, Q, this->sampleRate));
         }
 
         void setParams__LPF_Butterworth(float cutoffFrequency) {
@@ -332,16 +658,7 @@ namespace giml {
             if (this->useCase != BiquadUseCase::LPF_Butterworth) {
                 this->useCase = BiquadUseCase::LPF_Butterworth;
             }
-            //Q is fixed to sqrt(2) to avoid resonance
-            float C = 1 / ::tanf(M_PI * cutoffFrequency / this->sampleRate);
-            float CSquared = C * C;
-
-            this->a0 = 1 / (1 + M_SQRT2 * C + CSquared);
-            this->a1 = 2 * this->a0;
-            this->a2 = this->a0;
-
-            this->b1 = 2 * this->a0 * (1 - CSquared);
-            this->b2 = this->a0 * (1 - M_SQRT2 * C + CSquared);
+            this->setCoefficients(BiquadDesign<T>::LPF_Butterworth(cutoffFrequency, this->sampleRate));
         }
 
         void setParams__HPF_Butterworth(float cutoffFrequency) {
@@ -349,16 +666,7 @@ namespace giml {
             if (this->useCase != BiquadUseCase::HPF_Butterworth) {
                 this->useCase = BiquadUseCase::HPF_Butterworth;
             }
-            //Q is fixed to sqrt(2) to avoid resonance
-            float C = ::tanf(M_PI * cutoffFrequency / this->sampleRate);
-            float CSquared = C * C;
-
-            this->a0 = 1 / (1 + M_SQRT2 * C + CSquared);
-            this->a1 = -2 * this->a0;
-            this->a2 = this->a0;
-
-            this->b1 = 2 * this->a0 * (CSquared - 1);
-            this->b2 = this->a0 * (1 - M_SQRT2 * C + CSquared);
+            this->setCoefficients(BiquadDesign<T>::HPF_Butterworth(cutoffFrequency, this->sampleRate));
         }
 
         void setParams__BPF_Butterworth(float cutoffFrequency, float Q) {
@@ -366,16 +674,7 @@ namespace giml {
             if (this->useCase != BiquadUseCase::BPF_Butterworth) {
                 this->useCase = BiquadUseCase::BPF_Butterworth;
             }
-            float BW = cutoffFrequency / Q; //Bandwidth
-            float C = 1 / ::tanf(M_PI * cutoffFrequency * BW / this->sampleRate);
-            float D = 2 * ::tanf(M_2PI * cutoffFrequency / this->sampleRate);
-
-            this->a0 = 1 / (1 + C);
-            this->a1 = 0;
-            this->a2 = -this->a0;
-
-            this->b1 = -this->a0 * C * D;
-            this->b2 = this->a0 * (C - 1);
+            this->setCoefficients(BiquadDesign<T>::BPF_Butterworth(cutoffFrequency, Q, this->sampleRate));
         }
 
         void setParams__BSF_Butterworth(float cutoffFrequency, float Q) {
@@ -383,16 +682,7 @@ namespace giml {
             if (this->useCase != BiquadUseCase::BSF_Butterworth) {
                 this->useCase = BiquadUseCase::BSF_Butterworth;
             }
-            float BW = cutoffFrequency / Q; //Bandwidth
-            float C = ::tanf(M_PI * cutoffFrequency * BW / this->sampleRate);
-            float D = 2 * ::tanf(M_2PI * cutoffFrequency / this->sampleRate);
-
-            this->a0 = 1 / (1 + C);
-            this->a1 = 0;
-            this->a2 = -this->a0;
-
-            this->b1 = -this->a0 * C * D;
-            this->b2 = this->a0 * (C - 1);
+            this->setCoefficients(BiquadDesign<T>::BSF_Butterworth(cutoffFrequency, Q, this->sampleRate));
         }
 
         //void setParams__LPF_LR(float cutoffFrequency) {
@@ -418,14 +708,7 @@ namespace giml {
             if (this->useCase != BiquadUseCase::APF_1st) {
                 this->useCase = BiquadUseCase::APF_1st;
             }
-            float t = ::tanf(M_PI * cutoffFrequency / this->sampleRate);
-            float alpha = (t - 1) / (t + 1);
-            this->a0 = alpha;
-            this->a1 = 1;
-            this->a2 = 0;
-
-            this->b1 = alpha;
-            this->b2 = 0;
+            this->setCoefficients(BiquadDesign<T>::APF_1st(cutoffFrequency, this->sampleRate));
         }
 
         void setParams__APF_2nd(float cutoffFrequency, float Q) {
@@ -433,26 +716,7 @@ namespace giml {
             if (this->useCase != BiquadUseCase::APF_2nd) {
                 this->useCase = BiquadUseCase::APF_2nd;
             }
-            float cutoffAngle = M_2PI * cutoffFrequency / this->sampleRate;
-            float alpha = ::sinf(cutoffAngle) / (2 * Q);
-
-            this->a0 = (1 - alpha) / (1 + alpha);
-            this->a1 = -2 * ::cosf(cutoffAngle) / (1 + alpha);
-            this->a2 = 1;
-
-            this->b1 = this->a1;
-            this->b2 = this->a0;
-
-            /*float BW = cutoffFrequency / Q;
-            float t = ::tanf(M_PI * BW / this->sampleRate);
-            float alpha = (t - 1) / (t + 1);
-            float Beta = -::cosf(M_2PI * cutoffFrequency / this->sampleRate);
-            this->a0 = -alpha;
-            this->a1 = Beta * (1 - alpha);
-            this->a2 = 1;
-
-            this->b1 = Beta * (1 - alpha);
-            this->b2 = -alpha;*/
+            this->setCoefficients(BiquadDesign<T>::APF_2nd(cutoffFrequency, Q, this->sampleRate));
         }
 
         void setParams__LSF(float cutoffFrequency, float Q, float gainDB) {
@@ -460,117 +724,241 @@ namespace giml {
             if (this->useCase != BiquadUseCase::LSF) {
                 this->useCase = BiquadUseCase::LSF;
             }
-            float cutoffAngle = M_2PI * cutoffFrequency / this->sampleRate;
-            float A = giml::dBtoA(gainDB);
+            this->setCoefficients(BiquadDesign<T>::LSF(cutoffFrequency, Q, gainDB, this->sampleRate));
+        }
 
+        void setParams__HSF(float cutoffFrequency, float Q, float gainDB) {
+            //Set type to high-shelf if not already
+            if (this->useCase != BiquadUseCase::HSF) {
+                this->useCase = BiquadUseCase::HSF;
+            }
+            this->setCoefficients(BiquadDesign<T>::HSF(cutoffFrequency, Q, gainDB, this->sampleRate));
+        }
 
-            float cosss = ::cosf(cutoffAngle);
-            //Conversion between Q and shelf steepness (S)
-            //float gamma = ::sinf(cutoffAngle) * ::sqrtf((A * A + 1) * ((1 / (Q * Q) - 2) / (A + 1 / A)) + 2 * A);
-            float gamma = ::sinf(cutoffAngle) * ::sqrtf(A) / Q;
-            float alpha = (A + 1) * cosss;
-            float beta = (A - 1) * cosss;
-            float c = (A + 1) + beta + gamma;
+        void setParams__PEQ_constQ(float centerFrequency, float Q, float gainDB) {
+            //Set type to parametric EQ (const Q behavior) if not already
+            if (this->useCase != BiquadUseCase::PEQ_constQ) {
+                this->useCase = BiquadUseCase::PEQ_constQ;
+            }
+            this->setCoefficients(BiquadDesign<T>::PEQ_constQ(centerFrequency, Q, gainDB, this->sampleRate));
+        }
+    };
 
-            this->a0 = A * (A + 1 - beta + gamma) / c;
-            this->a1 = 2 * A * (A - 1 - alpha) / c;
-            this->a2 = A * (A + 1 - beta - gamma) / c;
+    /**
+     * @brief Picks the `giml::BiquadDesign` formula for a use case chosen at runtime (or at compile time with `BiquadConstexprMath`)
+     * @param type filter use case. Use cases without a design formula return pass-through coefficients
+     * @param cutoffFrequency cutoff (or center) frequency in Hz
+     * @param Q quality factor (ignored by first-order and Butterworth designs)
+     * @param gainDB shelf/PEQ gain in dB
+     * @param sampleRate sample rate of your project
+     * @return the designed coefficients
+     */
+    template <typename T, typename Math = BiquadRuntimeMath>
+    constexpr BiquadCoefficients<T> designBiquad(typename Biquad<T>::BiquadUseCase type, float cutoffFrequency, float Q, float gainDB, int sampleRate) {
+        using UseCase = typename Biquad<T>::BiquadUseCase;
+        using Design = BiquadDesign<T, Math>;
+        switch (type) {
+        case UseCase::LPF_1st:
+            return Design::LPF_1st(cutoffFrequency, sampleRate);
+        case UseCase::HPF_1st:
+            return Design::HPF_1st(cutoffFrequency, sampleRate);
+        case UseCase::APF_1st:
+            return Design::APF_1st(cutoffFrequency, sampleRate);
+        case UseCase::LPF_2nd:
+            return Design::LPF_2nd(cutoffFrequency, Q, sampleRate);
+        case UseCase::HPF_2nd:
+            return Design::HPF_2nd(cutoffFrequency, Q, sampleRate);
+        case UseCase::BPF:
+            return Design::BPF(cutoffFrequency, Q, sampleRate);
+        case UseCase::BSF:
+            return Design::BSF(cutoffFrequency, Q, sampleRate);
+        case UseCase::LPF_Butterworth:
+            return Design::LPF_Butterworth(cutoffFrequency, sampleRate);
+        case UseCase::HPF_Butterworth:
+            return Design::HPF_Butterworth(cutoffFrequency, sampleRate);
+        case UseCase::BPF_Butterworth:
+            return Design::BPF_Butterworth(cutoffFrequency, Q, sampleRate);
+        case UseCase::BSF_Butterworth:
+            return Design::BSF_Butterworth(cutoffFrequency, Q, sampleRate);
+        case UseCase::APF_2nd:
+            return Design::APF_2nd(cutoffFrequency, Q, sampleRate);
+        case UseCase::LSF:
+            return Design::LSF(cutoffFrequency, Q, gainDB, sampleRate);
+        case UseCase::HSF:
+            return Design::HSF(cutoffFrequency, Q, gainDB, sampleRate);
+        case UseCase::PEQ_constQ:
+            return Design::PEQ_constQ(cutoffFrequency, Q, gainDB, sampleRate);
+        default: //TODO: LPF_LR, HPF_LR, PEQ not yet implemented
+            return BiquadCoefficients<T>{ 1, 0, 0, 0, 0 };
+        }
+    }
+
+    /**
+     * @brief A `Biquad` whose type, cutoff, Q and sample rate are all known at build time
+     * (DC blockers, fixed anti-aliasing filters, etc.).
+     * 
+     * The coefficients are designed at compile time with `BiquadConstexprMath`, so there is no runtime design cost
+     * and no coefficient storage, only the filter state. Non-type template parameters cannot be floating-point
+     * before C++20, so Q and gain are given in thousandths. Basic usage:
+     * 
+     * giml::FixedBiquad<float, giml::Biquad<float>::BiquadUseCase::HPF_1st, 5> dcBlocker;
+     * giml::FixedBiquad<float, giml::Biquad<float>::BiquadUseCase::LPF_2nd, 18000, 707, 44100> antiAliasing;
+     * 
+     * @tparam T floating-point type for input and output sample data
+     * @tparam Type any `Biquad<T>::BiquadUseCase` that `Biquad<T>::processSample()` implements
+     * @tparam CutoffHz cutoff (or center) frequency in Hz
+     * @tparam QMilli Q multiplied by 1000 (707 = 0.707)
+     * @tparam SampleRate sample rate of your project
+     * @tparam GainMilliDB shelf/PEQ gain in thousandths of a dB
+     */
+    template <typename T, typename Biquad<T>::BiquadUseCase Type, int CutoffHz, int QMilli = 707, int SampleRate = 48000, int GainMilliDB = 0>
+    class FixedBiquad : public Effect<T> {
+    private:
+        using UseCase = typename Biquad<T>::BiquadUseCase;
 
-            this->b1 = -2 * (A - 1 + alpha) / c;
-            this->b2 = (A + 1 + beta - gamma) / c;
+        static_assert(Type == UseCase::LPF_1st || Type == UseCase::HPF_1st || Type == UseCase::APF_1st ||
+            Type == UseCase::LPF_2nd || Type == UseCase::HPF_2nd || Type == UseCase::LPF_Butterworth ||
+            Type == UseCase::HPF_Butterworth || Type == UseCase::APF_2nd || Type == UseCase::LSF ||
+            Type == UseCase::HSF || Type == UseCase::PEQ_constQ,
+            "FixedBiquad only supports the use cases implemented by Biquad::processSample()");
+        static_assert(CutoffHz > 0 && 2 * CutoffHz < SampleRate, "Cutoff must be between 0 and Nyquist");
 
+        //Past 2 x,y values
+        T prevX1 = 0, prevX2 = 0,
+            prevY1 = 0, prevY2 = 0;
 
-            /*float delta = 4 * ::tanf(cutoffFrequency / 2) / (1 + A);
-            float gamma = (1 - delta) / (1 + delta);
+    public:
+        /**
+         * @brief Evaluates the design formula for `Type` (at compile time when used in a constant expression)
+         * @return the filter's coefficients
+         */
+        static constexpr BiquadCoefficients<T> coefficients() {
+            return designBiquad<T, BiquadConstexprMath>(Type, CutoffHz, QMilli / 1000.f, GainMilliDB / 1000.f, SampleRate);
+        }
 
-            this->a0 = (1 - gamma) / 2;
-            this->a1 = this->a0;
-            this->a2 = 0;
+        T processSample(T in) {
+            constexpr BiquadCoefficients<T> c = coefficients(); //Immediate constants, nothing to load
+            T returnVal = c.a0 * in + c.a1 * prevX1 + c.a2 * prevX2 - c.b1 * prevY1 - c.b2 * prevY2;
 
-            this->b1 = -gamma;
-            this->b2 = 0;
+            //Back propagate inputs and outputs
+            prevX2 = prevX1;
+            prevX1 = in;
 
-            this->dry = 1;
-            this->wet = A - 1;*/
-        }
+            prevY2 = prevY1;
+            prevY1 = returnVal;
 
-        void setParams__HSF(float cutoffFrequency, float Q, float gainDB) {
-            //Set type to high-shelf if not already
-            if (this->useCase != BiquadUseCase::HSF) {
-                this->useCase = BiquadUseCase::HSF;
+            if (!(this->enabled)) {
+                return in;
             }
-            float cutoffAngle = M_2PI * cutoffFrequency / this->sampleRate;
-            float A = giml::dBtoA(gainDB);
 
-            float cosss = ::cosf(cutoffAngle);
-            //Conversion between Q and shelf steepness (S)
-            //float gamma = ::sinf(cutoffAngle) * ::sqrtf((A * A + 1) * ((1 / (Q * Q) - 2) / (A + 1 / A)) + 2 * A);
-            float gamma = ::sinf(cutoffAngle) * ::sqrtf(A) / Q;
-            float alpha = (A + 1) * cosss;
-            float beta = (A - 1) * cosss;
-            float c = (A + 1) - beta + gamma;
-
-            this->a0 = A * (A + 1 + beta + gamma) / c;
-            this->a1 = -2 * A * (A - 1 + alpha) / c;
-            this->a2 = A * (A + 1 + beta - gamma) / c;
-
-            this->b1 = 2 * (A - 1 - alpha) / c;
-            this->b2 = (A + 1 - beta - gamma) / c;
+            return returnVal;
+        }
+    };
 
-            //float delta = (1 + multiplier) * ::tanf(cutoffFrequency / 2) / 4;
-            //float gamma = (1 - delta) / (1 + delta);
+    /**
+     * @brief A bank of `Lanes` independent biquads (one per mono stream) that share a topology but not coefficients.
+     * 
+     * Coefficients and state are stored structure-of-arrays, so advancing every lane is the same handful of
+     * multiply-adds applied across contiguous arrays, which the compiler turns into one SIMD instruction sequence
+     * (4/8/16 lanes fill SSE/AVX/AVX-512 float registers). Basic usage:
+     * 
+     * giml::BiquadBank<float, 8> bank{48000};
+     * bank.setParams(0, giml::Biquad<float>::BiquadUseCase::LPF_2nd, 1000.f);
+     * bank.processBlock(interleavedIn, interleavedOut, numFrames);
+     * 
+     * @tparam T floating-point type for input and output sample data
+     * @tparam Lanes number of streams processed together
+     */
+    template <typename T, int Lanes = 8>
+    class BiquadBank {
+    private:
+        static_assert(Lanes > 0, "BiquadBank needs at least one lane");
+        int sampleRate;
 
-            //this->a0 = (1 + gamma) / 2;
-            //this->a1 = -this->a0;
-            //this->a2 = 0;
+        //Coefficients (pass-through by default)
+        T a0[Lanes], a1[Lanes], a2[Lanes], b1[Lanes], b2[Lanes];
+        //Past 2 x,y values
+        T prevX1[Lanes], prevX2[Lanes], prevY1[Lanes], prevY2[Lanes];
 
-            //this->b1 = -gamma;
-            //this->b2 = 0;
+    public:
+        BiquadBank() = delete;
+        BiquadBank(int sampleRate) : sampleRate(sampleRate) {
+            for (int i = 0; i < Lanes; i++) {
+                this->setCoefficients(i, BiquadCoefficients<T>{ 1, 0, 0, 0, 0 });
+            }
+            this->reset();
+        }
 
-            //this->dry = 1;
-            //this->wet = multiplier - 1;
+        /**
+         * @brief Design and set one lane's coefficients
+         * @param lane index in `[0, Lanes)`
+         * @param type filter use case
+         * @param cutoffFrequency cutoff (or center) frequency in Hz
+         * @param Q quality factor
+         * @param gainDB shelf/PEQ gain in dB
+         */
+        void setParams(int lane, typename Biquad<T>::BiquadUseCase type, float cutoffFrequency, float Q = 0.707, float gainDB = 0.f) {
+            this->setCoefficients(lane, designBiquad<T>(type, cutoffFrequency, Q, gainDB, this->sampleRate));
         }
 
-        void setParams__PEQ_constQ(float centerFrequency, float Q, float gainDB) {
-            //Set type to parametric EQ (const Q behavior) if not already
-            if (this->useCase != BiquadUseCase::PEQ_constQ) {
-                this->useCase = BiquadUseCase::PEQ_constQ;
+        /**
+         * @brief Set one lane's coefficients directly (e.g. from `giml::FixedBiquad::coefficients()`)
+         * @param lane index in `[0, Lanes)`
+         * @param c coefficients
+         */
+        void setCoefficients(int lane, const BiquadCoefficients<T>& c) {
+            if (lane < 0 || lane >= Lanes) {
+                printf("BiquadBank lane out of bounds\n");
+                return;
             }
+            this->a0[lane] = c.a0;
+            this->a1[lane] = c.a1;
+            this->a2[lane] = c.a2;
+            this->b1[lane] = c.b1;
+            this->b2[lane] = c.b2;
+        }
 
-            float K = ::tanf(M_PI * centerFrequency / this->sampleRate);
-            float KSquared = K * K;
-            float vol = giml::dBtoA(gainDB);
+        /**
+         * @brief Clears the state of every lane
+         */
+        void reset() {
+            for (int i = 0; i < Lanes; i++) {
+                this->prevX1[i] = this->prevX2[i] = this->prevY1[i] = this->prevY2[i] = 0;
+            }
+        }
 
-            float d = 1 + K / Q + KSquared;
-            float e = 1 + K / (vol * Q) + KSquared;
+        /**
+         * @brief Advances every lane by one sample
+         * @param in `Lanes` input samples, one per stream
+         * @param out `Lanes` output samples, one per stream (may be the same array as `in`)
+         */
+        void processSample(const T* in, T* out) {
+            for (int i = 0; i < Lanes; i++) {
+                T x = in[i];
+                T y = a0[i] * x + a1[i] * prevX1[i] + a2[i] * prevX2[i] - b1[i] * prevY1[i] - b2[i] * prevY2[i];
 
-            float alpha = 1 + vol * K / Q + KSquared;
-            float Beta = 2 * (KSquared - 1);
-            float gamma = 1 - vol * K / Q + KSquared;
-            float delta = 1 - K / Q + KSquared;
-            float nu = 1 - K / (vol * Q) + KSquared;
+                //Back propagate inputs and outputs
+                prevX2[i] = prevX1[i];
+                prevX1[i] = x;
 
-            if (gainDB >= 0) {
-                //Then we are boosting this range
-                this->a0 = alpha / d;
-                this->a1 = Beta / d;
-                this->a2 = gamma / d;
+                prevY2[i] = prevY1[i];
+                prevY1[i] = y;
 
-                this->b1 = this->a1;
-                this->b2 = delta / d;
+                out[i] = y;
             }
-            else {
-                //We are cutting this range
-                this->a0 = d / e;
-                this->a1 = Beta / e;
-                this->a2 = delta / e;
+        }
 
-                this->b1 = Beta / e;
-                this->b2 = nu / e;
+        /**
+         * @brief Processes `numFrames` frames of interleaved input (`in[frame * Lanes + lane]`)
+         * @param in interleaved input samples
+         * @param out interleaved output samples (may be the same array as `in`)
+         * @param numFrames number of frames to process
+         */
+        void processBlock(const T* in, T* out, int numFrames) {
+            for (int n = 0; n < numFrames; n++) {
+                this->processSample(in + n * Lanes, out + n * Lanes);
             }
         }
-
-
     };
 }
 
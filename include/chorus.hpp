@@ -3,25 +3,86 @@
 #include <math.h>
 #include "utility.hpp"
 #include "oscillator.hpp"
+#include "modbus.hpp"
 namespace giml {
     /**
-     * @brief This class implements a basic chorus effect
+     * @brief This class implements a basic chorus effect.
+     * With more than one voice it becomes an ensemble: every voice is a tap on the same delay line, modulated
+     * by the same triangle LFO at an evenly spaced phase offset and panned across the stereo field.
+     * The input is still written once per sample, and the taps' read positions are computed together
+     * (structure-of-arrays) before the buffer is read
      * @tparam T floating-point type for input and output sample data such as `float`, `double`, or `long double`,
      * up to user what precision they are looking for (float is more performant)
      */
     template <typename T>
     class Chorus : public Effect<T> {
     private:
+        static const int maxVoices = 8;
+
         int sampleRate;
-        float rate = 1.f, depth = 20.f, blend = 0.5f;
+        float rate = 1.f, depth = 20.f, spread = 1.f;
+        giml::SmoothedValue<T> blend{0.5}; // ramps to new values, see `setSmoothingTime()`
         giml::CircularBuffer<T> buffer;
         giml::TriOsc<T> osc;
+        giml::ModTap<T> modTap; // replaces `osc` when connected, see `setModSource()`
+        giml::SilenceDetector<T> silence; // see `setIdleDetection()`
+
+        int numVoices = 1;
+        T depthSamples; // depth in samples, updated by `setDepth()`
+        T voicePhaseOffset[maxVoices], panLeft[maxVoices], panRight[maxVoices]; // per-voice parameters
+        T readIndex[maxVoices], tap[maxVoices]; // scratch for the current sample
+
+        /**
+         * @brief Advances the LFO and reads every voice's tap into `tap`
+         */
+        void readTaps() {
+            // voice 0 is the plain chorus tap, the others follow it at their phase offsets
+            T lfo, phase;
+            if (this->modTap.isConnected()) {
+                lfo = this->modTap.next();
+                phase = this->modTap.getPhase();
+            } else {
+                lfo = this->osc.processSample();
+                phase = this->osc.getPhase();
+            }
+            for (int v = 0; v < this->numVoices; v++) {
+                T p = phase + this->voicePhaseOffset[v];
+                p -= (p >= 1) ? 1 : 0;
+                T tri = (v == 0) ? lfo : ::abs(p * 2 - 1) * 2 - 1; // same shape as `giml::TriOsc`
+                this->readIndex[v] = this->depthSamples + (this->depthSamples * 0.5) * tri;
+            }
+            for (int v = 0; v < this->numVoices; v++) {
+                this->tap[v] = this->buffer.readSample((float)this->readIndex[v]);
+            }
+        }
+
+        /**
+         * @brief Equal-power pan positions spread evenly over `[-spread, spread]`,
+         * scaled so that a centered voice has gain 1 in each channel
+         */
+        void updatePans() {
+            for (int v = 0; v < this->numVoices; v++) {
+                float pan = (this->numVoices > 1) ? this->spread * (2.f * v / (this->numVoices - 1) - 1.f) : 0.f;
+                float angle = (pan + 1.f) * M_PI / 4.f;
+                this->panLeft[v] = ::cosf(angle) * M_SQRT2;
+                this->panRight[v] = ::sinf(angle) * M_SQRT2;
+            }
+        }
 
     public:
         Chorus() = delete;
-        Chorus (int samprate, float maxDepthMillis = 150.f) : sampleRate(samprate), osc(samprate) {
+        /**
+         * @param samprate sample rate of your project
+         * @param maxDepthMillis longest allowed depth
+         * @param voices number of modulated taps (1 for a classic chorus, up to 8 for an ensemble)
+         */
+        Chorus (int samprate, float maxDepthMillis = 150.f, int voices = 1) : sampleRate(samprate), osc(samprate) {
             this->osc.setFrequency(this->rate);
             this->buffer.allocate(giml::millisToSamples(maxDepthMillis * 2.f, samprate)); // max delay is 100,000 samples
+            this->depthSamples = giml::millisToSamples(this->depth, samprate);
+            this->silence.setHoldSamples(this->depthSamples * 1.5);
+            this->setNumVoices(voices);
+            this->setSmoothingTime(20.f);
         }
 
         /**
@@ -32,17 +93,145 @@ namespace giml {
          * from current sample create pitch-shifting via the doppler effect 
          */
         T processSample(T in) {
+            if (this->silence.isIdle() && this->silence.isSilent(in)) {
+                this->buffer.writeSilence(1);
+                this->blend.skip(1);
+                this->osc.skip(1); // keep the LFO in time
+                return in;
+            }
             this->buffer.writeSample(in); // write sample to delay buffer
 
             if (!(this->enabled)) {
                 return in;
             }
 
-            float idealReadIndex = millisToSamples(this->depth, this->sampleRate) + 
-            (millisToSamples(this->depth, this->sampleRate) * 0.5) * this->osc.processSample();
+            this->readTaps();
+            T wet = 0;
+            for (int v = 0; v < this->numVoices; v++) {
+                wet += this->tap[v];
+            }
+            wet /= this->numVoices;
+            T b = this->blend.next();
+            T out = wet * b + in * (1-b); // mix
+            if (this->silence.isActive()) {
+                this->silence.update(this->silence.isSilent(in) && this->silence.isSilent(out), 1);
+            }
+            return out;
+        }
+
+        /**
+         * @brief Stereo version of `processSample()`: each voice is panned to its place in the stereo field
+         * @param in current sample
+         * @param outLeft left output
+         * @param outRight right output
+         */
+        void processSample(T in, T& outLeft, T& outRight) {
+            if (this->silence.isIdle() && this->silence.isSilent(in)) {
+                this->buffer.writeSilence(1);
+                this->blend.skip(1);
+                this->osc.skip(1); // keep the LFO in time
+                outLeft = outRight = in;
+                return;
+            }
+            this->buffer.writeSample(in); // write sample to delay buffer
+
+            if (!(this->enabled)) {
+                outLeft = outRight = in;
+                return;
+            }
+
+            this->readTaps();
+            T wetLeft = 0, wetRight = 0;
+            for (int v = 0; v < this->numVoices; v++) {
+                wetLeft += this->tap[v] * this->panLeft[v];
+                wetRight += this->tap[v] * this->panRight[v];
+            }
+            T b = this->blend.next();
+            outLeft = wetLeft / this->numVoices * b + in * (1-b);
+            outRight = wetRight / this->numVoices * b + in * (1-b);
+            if (this->silence.isActive()) {
+                this->silence.update(this->silence.isSilent(in) && this->silence.isSilent(outLeft) && this->silence.isSilent(outRight), 1);
+            }
+        }
+
+        /**
+         * @brief Process a block of samples
+         * @param in input samples
+         * @param out output samples (may be the same as `in`)
+         * @param numSamples number of samples
+         */
+        void processBlock(const T* in, T* out, int numSamples) {
+            if (!(this->enabled)) {
+                for (int i = 0; i < numSamples; i++) {
+                    out[i] = this->processSample(in[i]);
+                }
+                return;
+            }
+            bool silentIn = this->silence.isActive() && this->silence.isSilent(in, numSamples);
+            if (silentIn && this->silence.isIdle()) { // the delay line only holds silence, only its write position moves on
+                ::memmove(out, in, numSamples * sizeof(T));
+                this->buffer.writeSilence(numSamples);
+                this->blend.skip(numSamples);
+                this->osc.skip(numSamples); // keep the LFO in time
+                return;
+            }
+            T wetBlock[SmoothedValue<T>::maxBlock], blendBlock[SmoothedValue<T>::maxBlock];
+            SmoothedValue<T>::forEachChunk(numSamples, [&](int start, int n) {
+                for (int i = 0; i < n; i++) {
+                    this->buffer.writeSample(in[start + i]);
+                    this->readTaps();
+                    T wet = 0;
+                    for (int v = 0; v < this->numVoices; v++) {
+                        wet += this->tap[v];
+                    }
+                    wetBlock[i] = wet / this->numVoices;
+                }
+                this->blend.fillBlock(blendBlock, n);
+                for (int i = 0; i < n; i++) { // vectorizes
+                    out[start + i] = wetBlock[i] * blendBlock[i] + in[start + i] * (1 - blendBlock[i]);
+                }
+            });
+            if (this->silence.isActive()) {
+                this->silence.update(silentIn && this->silence.isSilent(out, numSamples), numSamples);
+            }
+        }
+
+        /**
+         * @brief Lets the chorus idle once its input has been silent for longer than its longest delay: silent
+         * samples are then passed straight through without reading the delay line (only zeros are written, so a
+         * later `setDepth()` can't bring back old audio), and the first sample with sound wakes it again
+         * @param on whether to idle (off by default)
+         * @param thresholdDB level below which a sample counts as silent
+         */
+        void setIdleDetection(bool on, float thresholdDB = -90.f) {
+            this->silence.setActive(on, thresholdDB);
+        }
 
-            T wet = this->buffer.readSample(idealReadIndex);
-            return wet * blend + in * (1-blend); // return mix
+        /**
+         * @return whether the chorus is currently idling (see `setIdleDetection()`)
+         */
+        bool isIdle() const {
+            return this->silence.isIdle();
+        }
+
+        /**
+         * @return the longest delay a voice can read, in seconds
+         */
+        float getTailLength() override {
+            return this->depthSamples * 1.5f / this->sampleRate;
+        }
+
+        /**
+         * @brief Process a block of mono samples into stereo
+         * @param in input samples
+         * @param outLeft left output samples
+         * @param outRight right output samples
+         * @param numSamples number of samples
+         */
+        void processBlock(const T* in, T* outLeft, T* outRight, int numSamples) {
+            for (int i = 0; i < numSamples; i++) {
+                this->processSample(in[i], outLeft[i], outRight[i]);
+            }
         }
 
         /**
@@ -53,6 +242,15 @@ namespace giml {
             this->osc.setFrequency(freq); // set frequency in Hz
         }
 
+        /**
+         * @brief Use a shared LFO from a `giml::ModBus` instead of `osc` (the other voices follow its phase)
+         * @param bus bus to read from (`nullptr` goes back to `osc`)
+         * @param source index returned by `ModBus::addSource()`
+         */
+        void setModSource(const giml::ModBus<T>* bus, int source = 0) {
+            this->modTap.connect(bus, source);
+        }
+
         /**
          * @brief Set modulation depth- the average delay time
          * @param d depth in milliseconds
@@ -62,6 +260,29 @@ namespace giml {
                 d = giml::samplesToMillis(this->buffer.size(), this->sampleRate) / 2.f;
             }
             this->depth = d;
+            this->depthSamples = giml::millisToSamples(d, this->sampleRate);
+            this->silence.setHoldSamples(this->depthSamples * 1.5);
+        }
+
+        /**
+         * @brief Set the number of voices, their LFOs are spread evenly over one cycle
+         * @param voices number of modulated taps (clamped to [1, 8])
+         */
+        void setNumVoices(int voices) {
+            this->numVoices = giml::clip<int>(voices, 1, maxVoices);
+            for (int v = 0; v < this->numVoices; v++) {
+                this->voicePhaseOffset[v] = v / (T)this->numVoices;
+            }
+            this->updatePans();
+        }
+
+        /**
+         * @brief Set how widely the voices are panned
+         * @param s 0 for all voices centered, 1 for the outermost voices hard left and right (clamped to [0,1])
+         */
+        void setSpread(float s) {
+            this->spread = giml::clip<float>(s, 0.f, 1.f);
+            this->updatePans();
         }
 
         /**
@@ -73,7 +294,14 @@ namespace giml {
             if (b > 1) {b = 1.f;} 
             else if (b < 0) {b = 0.f;}
             // set blend
-            this->blend = b;
+            this->blend.setTarget(b);
+        }
+
+        /**
+         * @brief Sets the ramp time of blend (see `giml::SmoothedValue::setRampTime()`)
+         */
+        void setSmoothingTime(float rampMillis) {
+            this->blend.setRampTime(rampMillis, this->sampleRate);
         }
     };
 }
@@ -12,9 +12,9 @@ namespace giml {
     class Compressor : public Effect<T> {
     private:
         int sampleRate;
-        float thresh_dB = 0.f, ratio = 2.f, knee_dB = 1.f;
+        float ratio = 2.f, knee_dB = 1.f;
         float aRelease = 0.f, aAttack = 0.f;
-        float makeupGain_dB = 0.f;
+        giml::SmoothedValue<T> thresh_dB{0}, makeupGain_dB{0}; // ramp to new values in dB, see `setSmoothingTime()`
         class DetectdB { // encapsulated detector class
         private:
             T y1last = 0;
@@ -36,6 +36,20 @@ namespace giml {
         };
         DetectdB detector; // member instance of detector class
 
+        /**
+         * @brief One sample of `processSample()` with this sample's (smoothed) threshold and makeup gain
+         */
+        inline T process(T in, T threshdB, T makeupdB) {
+            T xG = giml::aTodB(in); // xG
+            T yG = computeGain(xG, threshdB, this->ratio, this->knee_dB); // yG
+            T xL = xG - yG; // xL
+            T yL = this->detector.process(xL, this->aAttack, this->aRelease); // yL
+            T cdB = makeupdB - yL; // cdB = M - yL
+
+            T gain = giml::dBtoA(cdB); // lin()
+            return (in * gain); // apply gain
+        }
+
     protected: 
         /**
          * @brief Applies gain reduction in the log domain
@@ -66,7 +80,9 @@ namespace giml {
     public:
         //Constructor
         Compressor() = delete; // Do not allow an empty constructor, they must pass in a sampleRate
-        Compressor(int sampleRate) : sampleRate(sampleRate) {}
+        Compressor(int sampleRate) : sampleRate(sampleRate) {
+            this->setSmoothingTime(20.f);
+        }
         //Copy Constructor
         Compressor(const Compressor<T>& c) {
             //TODO:
@@ -82,15 +98,29 @@ namespace giml {
             if (!(this->enabled)) {
                 return in;
             }
+            T threshdB = this->thresh_dB.next();
+            return this->process(in, threshdB, this->makeupGain_dB.next());
+        }
 
-            T xG = giml::aTodB(in); // xG
-            T yG = computeGain(xG, this->thresh_dB, this->ratio, this->knee_dB); // yG
-            T xL = xG - yG; // xL
-            T yL = this->detector.process(xL, this->aAttack, this->aRelease); // yL
-            T cdB = this->makeupGain_dB - yL; // cdB = M - yL
-
-            T gain = giml::dBtoA(cdB); // lin()
-            return (in * gain); // apply gain
+        /**
+         * @brief Process a block of samples
+         * @param in input samples
+         * @param out output samples (may be the same as `in`)
+         * @param numSamples number of samples
+         */
+        void processBlock(const T* in, T* out, int numSamples) {
+            if (!(this->enabled)) {
+                ::memmove(out, in, numSamples * sizeof(T));
+                return;
+            }
+            T threshBlock[SmoothedValue<T>::maxBlock], makeupBlock[SmoothedValue<T>::maxBlock];
+            SmoothedValue<T>::forEachChunk(numSamples, [&](int start, int n) {
+                this->thresh_dB.fillBlock(threshBlock, n);
+                this->makeupGain_dB.fillBlock(makeupBlock, n);
+                for (int i = 0; i < n; i++) {
+                    out[start + i] = this->process(in[start + i], threshBlock[i], makeupBlock[i]);
+                }
+            });
         }
         /**
          * @brief set attack time 
@@ -135,7 +165,7 @@ namespace giml {
          * @param threshdB threshold in dB
          */
         void setThresh(float threshdB) {
-            this->thresh_dB = threshdB;
+            this->thresh_dB.setTarget(threshdB);
         }
         
         /**
@@ -156,7 +186,15 @@ namespace giml {
          */
         void setMakeupGain(float mdB) {
             if (mdB < 0.f) {mdB = 0.f;}
-            this->makeupGain_dB = mdB;
+            this->makeupGain_dB.setTarget(mdB);
+        }
+
+        /**
+         * @brief Sets the ramp time of threshold and makeup gain (see `giml::SmoothedValue::setRampTime()`)
+         */
+        void setSmoothingTime(float rampMillis) {
+            this->thresh_dB.setRampTime(rampMillis, this->sampleRate);
+            this->makeupGain_dB.setRampTime(rampMillis, this->sampleRate);
         }
     };
 }
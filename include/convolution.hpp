@@ -0,0 +1,419 @@
+#ifndef GIML_CONVOLUTION_HPP
+#define GIML_CONVOLUTION_HPP
+#include "utility.hpp"
+#include "fft.hpp"
+namespace giml {
+    /**
+     * @brief Convolution Reverb Effect
+     *
+     * Convolves the input with a measured impulse response (IR) of a real room. Convolving directly costs
+     * one multiply per IR sample per output sample (over 100,000 for a 3 second IR), so only the first
+     * `headLength` taps are convolved directly. The rest of the IR is split into partitions that are
+     * convolved in the frequency domain, where a block of L samples costs two FFTs plus one complex
+     * multiply per bin per partition.
+     *
+     * Partitions get bigger the later they start in the IR (`headLength`, then 8x, then 8x again...):
+     * a partition of size L starting at tap L (or later) only has to be ready L samples after its input
+     * block was collected, so there is no added latency. The multiply-adds for the older input blocks are
+     * spread over the `headLength`-sample periods in between, which keeps the CPU cost of each audio
+     * block roughly even.
+     *
+     * @tparam T floating-point type
+     */
+    template <typename T>
+    class ConvolutionReverb : public Effect<T> {
+    private:
+        static const int stageGrowth = 8; //Each partition stage is this many times bigger than the last
+        static const int maxPartitionSize = 4096; //The last stage covers the rest of the IR with this size
+
+        int sampleRate;
+        int headLength; //Number of taps convolved directly (and size of the smallest partition)
+
+        T* pIR = nullptr; //Kept so copies can rebuild their partitions
+        size_t irLength = 0;
+
+        //Direct-form head
+        T* pHeadTaps = nullptr; //First headLength taps of the IR, reversed
+        T* pHeadHistory = nullptr; //Last headLength inputs, stored twice so reads never wrap
+        int headIndex = 0;
+
+        //Shared input history for the partitioned stages, one largest partition long
+        T* pInputHistory = nullptr;
+        size_t inputLength = 0;
+
+        //Stage outputs get added into this ring and read back one sample at a time
+        T* pOutput = nullptr;
+        size_t outputLength = 0;
+
+        size_t sampleCount = 0; //Samples processed since the last IR change or reset
+
+        /**
+         * @brief One set of uniformly sized partitions of the IR, convolved with a frequency-domain delay line
+         * (FDL): the spectra of the last `numPartitions` input blocks are kept and each one is multiplied by
+         * the matching partition's spectrum. Inputs are real, so real FFTs are used and only bins 0 to L
+         * are stored and multiplied
+         */
+        template <typename U>
+        class PartitionedStage {
+        private:
+            int blockSize, fftSize, numBins, numPartitions;
+            size_t tapOffset; //First IR tap this stage covers
+            int partitionsPerTick, nextPartition = 1;
+            int fdlIndex = 0; //FDL slot holding the most recent input block
+            FFT<U> fft;
+
+            U *pFilterRe = nullptr, *pFilterIm = nullptr; //numPartitions spectra of numBins bins
+            U *pInputRe = nullptr, *pInputIm = nullptr; //FDL, numPartitions spectra of numBins bins
+            U *pAccumRe = nullptr, *pAccumIm = nullptr; //Sum for the upcoming block, numBins bins
+            U* pWork = nullptr; //fftSize real samples
+
+            /**
+             * @brief Multiply-adds one FDL entry with one partition into the accumulator
+             * @param p partition index
+             * @param slot FDL slot of the input block that meets partition `p`
+             */
+            void accumulatePartition(int p, int slot) {
+                const U* xRe = this->pInputRe + slot * this->numBins;
+                const U* xIm = this->pInputIm + slot * this->numBins;
+                const U* hRe = this->pFilterRe + p * this->numBins;
+                const U* hIm = this->pFilterIm + p * this->numBins;
+                for (int k = 0; k < this->numBins; k++) {
+                    this->pAccumRe[k] += xRe[k] * hRe[k] - xIm[k] * hIm[k];
+                    this->pAccumIm[k] += xRe[k] * hIm[k] + xIm[k] * hRe[k];
+                }
+            }
+
+            void forwardTransform(const U* block, U* re, U* im) {
+                ::memcpy(this->pWork, block, this->blockSize * sizeof(U));
+                ::memset(this->pWork + this->blockSize, 0, (this->fftSize - this->blockSize) * sizeof(U));
+                this->fft.forwardReal(this->pWork, re, im);
+            }
+
+            /**
+             * @brief Partition `p` of the upcoming block meets the input block `p` blocks before it
+             */
+            void accumulateOlderPartition(int p) {
+                int slot = this->fdlIndex - (p - 1);
+                slot += (slot < 0) ? this->numPartitions : 0; // circular logic
+                this->accumulatePartition(p, slot);
+            }
+
+        public:
+            /**
+             * @param blockSize partition size L
+             * @param tapOffset first IR tap this stage covers, must be at least `blockSize` for zero latency
+             * @param taps the part of the IR this stage covers
+             * @param numTaps number of taps in `taps`
+             * @param ticksPerBlock number of `tick()` calls between two blocks
+             */
+            PartitionedStage(int blockSize, size_t tapOffset, const U* taps, size_t numTaps, int ticksPerBlock) : blockSize(blockSize), tapOffset(tapOffset) {
+                this->fftSize = 2 * blockSize;
+                this->numBins = blockSize + 1;
+                this->numPartitions = (numTaps + blockSize - 1) / blockSize;
+                this->partitionsPerTick = (this->numPartitions - 1 + ticksPerBlock - 1) / ticksPerBlock;
+                this->fft.prepare(this->fftSize);
+
+                size_t spectraSize = this->numPartitions * this->numBins;
+                this->pFilterRe = (U*)::calloc(spectraSize, sizeof(U));
+                this->pFilterIm = (U*)::calloc(spectraSize, sizeof(U));
+                this->pInputRe = (U*)::calloc(spectraSize, sizeof(U));
+                this->pInputIm = (U*)::calloc(spectraSize, sizeof(U));
+                this->pAccumRe = (U*)::calloc(this->numBins, sizeof(U));
+                this->pAccumIm = (U*)::calloc(this->numBins, sizeof(U));
+                this->pWork = (U*)::calloc(this->fftSize, sizeof(U));
+
+                U* partition = (U*)::calloc(blockSize, sizeof(U));
+                for (int p = 0; p < this->numPartitions; p++) {
+                    for (int i = 0; i < blockSize; i++) {
+                        size_t tap = (size_t)p * blockSize + i;
+                        partition[i] = (tap < numTaps) ? taps[tap] : 0;
+                    }
+                    this->forwardTransform(partition, this->pFilterRe + p * this->numBins, this->pFilterIm + p * this->numBins);
+                }
+                ::free(partition);
+            }
+            //Copy constructor
+            PartitionedStage(const PartitionedStage<U>&) = delete;
+            //Copy assignment operator
+            PartitionedStage<U>& operator=(const PartitionedStage<U>&) = delete;
+            //Destructor
+            ~PartitionedStage() {
+                ::free(this->pFilterRe);
+                ::free(this->pFilterIm);
+                ::free(this->pInputRe);
+                ::free(this->pInputIm);
+                ::free(this->pAccumRe);
+                ::free(this->pAccumIm);
+                ::free(this->pWork);
+            }
+
+            int getBlockSize() const {
+                return this->blockSize;
+            }
+
+            size_t getTapOffset() const {
+                return this->tapOffset;
+            }
+
+            /**
+             * @brief Clears the FDL and the accumulator
+             */
+            void reset() {
+                size_t spectraSize = this->numPartitions * this->numBins;
+                ::memset(this->pInputRe, 0, spectraSize * sizeof(U));
+                ::memset(this->pInputIm, 0, spectraSize * sizeof(U));
+                ::memset(this->pAccumRe, 0, this->numBins * sizeof(U));
+                ::memset(this->pAccumIm, 0, this->numBins * sizeof(U));
+                this->fdlIndex = 0;
+                this->nextPartition = 1;
+            }
+
+            /**
+             * @brief Does a slice of the multiply-adds for the upcoming block (the ones that only need older inputs)
+             */
+            void tick() {
+                int end = giml::clip<int>(this->nextPartition + this->partitionsPerTick, 0, this->numPartitions);
+                for (; this->nextPartition < end; this->nextPartition++) {
+                    this->accumulateOlderPartition(this->nextPartition);
+                }
+            }
+
+            /**
+             * @brief Convolves the block of inputs that was just completed with the whole stage
+             * @param block the last `getBlockSize()` input samples
+             * @return `2 * getBlockSize()` output samples to overlap-add (owned by the stage)
+             */
+            const U* processBlock(const U* block) {
+                //Finish anything the ticks didn't get to
+                for (; this->nextPartition < this->numPartitions; this->nextPartition++) {
+                    this->accumulateOlderPartition(this->nextPartition);
+                }
+
+                //Add the newest block into the FDL and multiply it with the first partition
+                this->fdlIndex++;
+                if (this->fdlIndex >= this->numPartitions) {
+                    this->fdlIndex = 0; // circular logic
+                }
+                this->forwardTransform(block, this->pInputRe + this->fdlIndex * this->numBins, this->pInputIm + this->fdlIndex * this->numBins);
+                this->accumulatePartition(0, this->fdlIndex);
+
+                this->fft.inverseReal(this->pAccumRe, this->pAccumIm, this->pWork);
+
+                ::memset(this->pAccumRe, 0, this->numBins * sizeof(U));
+                ::memset(this->pAccumIm, 0, this->numBins * sizeof(U));
+                this->nextPartition = 1;
+                return this->pWork;
+            }
+        };
+        DynamicArray<PartitionedStage<T>*> stages;
+
+        void release() {
+            while (this->stages.size() > 0) {
+                delete this->stages.popBack();
+            }
+            ::free(this->pIR);
+            ::free(this->pHeadTaps);
+            ::free(this->pHeadHistory);
+            ::free(this->pInputHistory);
+            ::free(this->pOutput);
+            this->pIR = this->pHeadTaps = this->pHeadHistory = this->pInputHistory = this->pOutput = nullptr;
+            this->irLength = this->inputLength = this->outputLength = 0;
+        }
+
+    public:
+        //Constructor
+        ConvolutionReverb() = delete;
+        /**
+         * @param sampleRate sample rate of your project
+         * @param headLength number of taps convolved directly, rounded up to a power of 2. Also the size of the
+         * smallest partition, so the CPU load is spread over blocks of this size (set it to your audio block size)
+         */
+        ConvolutionReverb(int sampleRate, int headLength = 64) : sampleRate(sampleRate) {
+            int length = 1;
+            while (length < headLength) {
+                length *= 2;
+            }
+            this->headLength = length;
+            this->setImpulseResponse(nullptr, 0);
+        }
+        //Copy constructor (the copy starts with silent state)
+        ConvolutionReverb(const ConvolutionReverb<T>& c) : sampleRate(c.sampleRate), headLength(c.headLength) {
+            this->enabled = c.enabled;
+            this->setImpulseResponse(c.pIR, c.irLength);
+        }
+        //Copy assignment operator (the copy starts with silent state)
+        ConvolutionReverb<T>& operator=(const ConvolutionReverb<T>& c) {
+            if (this != &c) {
+                this->enabled = c.enabled;
+                this->sampleRate = c.sampleRate;
+                this->headLength = c.headLength;
+                this->setImpulseResponse(c.pIR, c.irLength);
+            }
+            return *this;
+        }
+        //Destructor
+        ~ConvolutionReverb() {
+            this->release();
+        }
+
+        /**
+         * @brief Sets the impulse response and partitions it. Allocates, so call it outside the audio callback
+         * @param ir impulse response samples (at the project's sample rate)
+         * @param length number of samples in `ir`
+         */
+        void setImpulseResponse(const T* ir, size_t length) {
+            this->release();
+            this->irLength = length;
+            this->pIR = (T*)::calloc(length + 1, sizeof(T));
+            if (length > 0) {
+                ::memcpy(this->pIR, ir, length * sizeof(T));
+            }
+
+            //Direct-form head
+            this->pHeadTaps = (T*)::calloc(this->headLength, sizeof(T));
+            this->pHeadHistory = (T*)::calloc(2 * this->headLength, sizeof(T));
+            this->headIndex = 0;
+            for (int i = 0; i < this->headLength && (size_t)i < length; i++) {
+                this->pHeadTaps[this->headLength - 1 - i] = this->pIR[i];
+            }
+
+            //Partitioned stages: a stage of size L starts at tap L and covers up to tap L * stageGrowth,
+            //the last one (once the next would be bigger than maxPartitionSize) covers the rest of the IR
+            size_t start = this->headLength;
+            size_t largestBlock = this->headLength, longestOutput = 0;
+            while (start < length) {
+                int blockSize = start;
+                bool lastStage = (blockSize * stageGrowth > maxPartitionSize);
+                size_t end = (lastStage) ? length : giml::clip<size_t>(start * stageGrowth, start, length);
+                int ticksPerBlock = blockSize / this->headLength;
+                this->stages.pushBack(new PartitionedStage<T>(blockSize, start, this->pIR + start, end - start, ticksPerBlock));
+                largestBlock = blockSize;
+                longestOutput = start + blockSize; //Furthest a stage's output reaches past the current sample
+                start = end;
+            }
+
+            this->inputLength = largestBlock;
+            this->pInputHistory = (T*)::calloc(this->inputLength, sizeof(T));
+            this->outputLength = longestOutput + 1;
+            this->pOutput = (T*)::calloc(this->outputLength, sizeof(T));
+            this->sampleCount = 0;
+        }
+
+        /**
+         * @brief Loads an impulse response from anything with a `bool readSample(float*)` method and a
+         * `sampleRate` member (like the `WAVLoader` used by the tests). Allocates, so call it outside the audio callback
+         * @param loader source of IR samples, read until `readSample()` returns false
+         * @param maxLength stop reading after this many samples (0 for no limit)
+         */
+        template <typename Loader>
+        void loadImpulseResponse(Loader& loader, size_t maxLength = 0) {
+            if (loader.sampleRate != this->sampleRate) {
+                printf("Impulse response sample rate does not match, it will not be resampled\n");
+            }
+            DynamicArray<T> ir;
+            float sample = 0.f;
+            while ((maxLength == 0 || ir.size() < maxLength) && loader.readSample(&sample)) {
+                ir.pushBack(sample);
+            }
+            T* samples = (T*)::calloc(ir.size() + 1, sizeof(T));
+            for (size_t i = 0; i < ir.size(); i++) {
+                samples[i] = ir[i];
+            }
+            this->setImpulseResponse(samples, ir.size());
+            ::free(samples);
+        }
+
+        size_t getImpulseResponseLength() const {
+            return this->irLength;
+        }
+
+        /**
+         * @return the impulse response length in seconds, which is how long the output lasts after the input stops
+         */
+        float getTailLength() override {
+            return (float)this->irLength / this->sampleRate;
+        }
+
+        /**
+         * @brief Clears the input history and any pending output
+         */
+        void reset() {
+            ::memset(this->pHeadHistory, 0, 2 * this->headLength * sizeof(T));
+            ::memset(this->pInputHistory, 0, this->inputLength * sizeof(T));
+            ::memset(this->pOutput, 0, this->outputLength * sizeof(T));
+            for (size_t s = 0; s < this->stages.size(); s++) {
+                this->stages[s]->reset();
+            }
+            this->headIndex = 0;
+            this->sampleCount = 0;
+        }
+
+        /**
+         * @brief Function to process one sound sample through the `ConvolutionReverb` effect at a time
+         *
+         * @param in floating-point type input
+         * @return T floating-point (float or double) output
+         */
+        T processSample(T in) {
+            if (!(this->enabled)) {
+                return in;
+            }
+
+            //Direct-form head
+            this->pHeadHistory[this->headIndex] = in;
+            this->pHeadHistory[this->headIndex + this->headLength] = in;
+            const T* history = this->pHeadHistory + this->headIndex + 1; //Oldest to newest
+            T out = 0;
+            for (int i = 0; i < this->headLength; i++) {
+                out += this->pHeadTaps[i] * history[i];
+            }
+            this->headIndex++;
+            if (this->headIndex >= this->headLength) {
+                this->headIndex = 0; // circular logic
+            }
+
+            //Partitioned tail
+            size_t outputIndex = this->sampleCount % this->outputLength;
+            out += this->pOutput[outputIndex];
+            this->pOutput[outputIndex] = 0;
+            this->pInputHistory[this->sampleCount % this->inputLength] = in;
+
+            this->sampleCount++;
+            if (this->sampleCount % this->headLength == 0) {
+                for (size_t s = 0; s < this->stages.size(); s++) {
+                    PartitionedStage<T>* stage = this->stages[s];
+                    size_t L = stage->getBlockSize();
+                    if (this->sampleCount % L == 0) {
+                        //The block that was just collected starts at (sampleCount - L) and its stage starts at tap
+                        //offset >= L, so its first output sample lands on or after the next sample to be read
+                        const T* block = this->pInputHistory + (this->sampleCount - L) % this->inputLength;
+                        const T* result = stage->processBlock(block);
+                        size_t writeIndex = (this->sampleCount - L + stage->getTapOffset()) % this->outputLength;
+                        for (size_t i = 0; i < 2 * L; i++) {
+                            this->pOutput[writeIndex] += result[i];
+                            writeIndex++;
+                            if (writeIndex >= this->outputLength) {
+                                writeIndex = 0; // circular logic
+                            }
+                        }
+                    }
+                    stage->tick();
+                }
+            }
+            return out;
+        }
+
+        /**
+         * @brief Process a block of samples
+         * @param in input samples
+         * @param out output samples (may be the same as `in`)
+         * @param numSamples number of samples
+         */
+        void processBlock(const T* in, T* out, int numSamples) {
+            for (int i = 0; i < numSamples; i++) {
+                out[i] = this->processSample(in[i]);
+            }
+        }
+    };
+}
+#endif
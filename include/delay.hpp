@@ -12,12 +12,91 @@ namespace giml {
      */
     template <typename T>
     class Delay : public Effect<T> {
+    public:
+        /**
+         * @brief How the read position follows `setDelayTime()`
+         */
+        enum class SmoothingMode {
+            NONE, // jump straight to the new time (may click)
+            GLIDE, // slide the read head to the new time with a one-pole (pitch bends like a tape delay)
+            CROSSFADE // fade from the old read position to the new one (no pitch change)
+        };
+
     private:
         int sampleRate;
-        T feedback = 0, delayTime = 0, blend = 0.5, damping = 0;
+        T delayTime = 0, damping = 0;
+        giml::SmoothedValue<T> feedback{0}, blend{0.5}; // ramp to new values, see `setSmoothingTime()`
+        T targetDelay = 0; // delayTime in samples, updated by `setDelayTime()`
+        SmoothingMode smoothingMode = SmoothingMode::NONE;
+        T smoothingSamples = 0; // glide time constant or crossfade length in samples
+        T glideCoefficient = 0, currentDelay = 0; // GLIDE state
+        T fadeIncrement = 1, fadePosition = 0, fadeFrom = 0, fadeTo = 0; // CROSSFADE state
         giml::onePole<T> loPass; // loPass filter for damping
         giml::onePole<T> dcBlock; // See Generating Sound & Organizing Time I - Wakefield and Taylor 2022 Chapter 7 pg. 204
         giml::CircularBuffer<T> buffer; // circular buffer to store past  values
+        giml::SilenceDetector<T> silence; // see `setIdleDetection()`
+        T tailSamples = 0; // updated by `updateTail()`
+
+        /**
+         * @brief Reads the buffer at the (smoothed) delay time
+         */
+        T readDelayed() {
+            switch (this->smoothingMode) {
+            case SmoothingMode::GLIDE:
+                this->currentDelay = this->targetDelay + (this->currentDelay - this->targetDelay) * this->glideCoefficient;
+                return this->buffer.readSample(this->currentDelay);
+            case SmoothingMode::CROSSFADE:
+                if (this->fadePosition <= 0 && this->fadeFrom != this->targetDelay) { // start a new fade once the last one is done
+                    this->fadeTo = this->targetDelay;
+                    this->fadePosition = this->fadeIncrement;
+                }
+                if (this->fadePosition > 0) {
+                    T out = giml::linMix<T>(this->buffer.readSample(this->fadeFrom), this->buffer.readSample(this->fadeTo), this->fadePosition);
+                    this->fadePosition += this->fadeIncrement;
+                    if (this->fadePosition >= 1) {
+                        this->fadePosition = 0;
+                        this->fadeFrom = this->fadeTo;
+                    }
+                    return out;
+                }
+                return this->buffer.readSample(this->fadeFrom);
+            default:
+                return this->buffer.readSample(this->targetDelay);
+            }
+        }
+
+        /**
+         * @brief One sample of `processSample()` with the feedback and blend for this sample
+         */
+        inline T process(T in, T fbGain, T gWet) {
+            T y_0 = loPass.lpf(this->readDelayed()); // read from buffer and loPass
+            this->buffer.writeSample(giml::undenormalize(this->dcBlock.hpf(in + giml::limit<T>(y_0 * fbGain, 0.75)))); // write sample to delay buffer
+
+          return giml::linMix<float>(in, y_0, gWet); // return wet/dry mix
+        }
+
+        /**
+         * @brief Recalculates how long the echoes last: each repeat is `feedback` times quieter than the last,
+         * so they reach -60dB after `3 / -log10(|feedback|)` repeats
+         */
+        void updateTail() {
+            T longest = this->targetDelay;
+            if (this->smoothingMode != SmoothingMode::NONE) { // the read head may still be on its way from an older time
+                longest = (this->currentDelay > longest) ? this->currentDelay : longest;
+                longest = (this->fadeFrom > longest) ? this->fadeFrom : longest;
+            }
+            T g = ::fabs(this->feedback.getTarget());
+            if (g >= 1) {
+                this->tailSamples = INFINITY;
+            }
+            else if (g == 0) {
+                this->tailSamples = longest;
+            }
+            else {
+                this->tailSamples = longest * (1 - 3 / ::log10(g));
+            }
+            this->silence.setHoldSamples(this->tailSamples);
+        }
 
     public:
         Delay() = delete;
@@ -25,6 +104,8 @@ namespace giml {
             this->buffer.allocate(giml::millisToSamples(maxDelayMillis, samprate)); // max delayTime = maxDelay
             this->loPass.setG(this->damping); // set damping 
             this->dcBlock.setCutoff(3, samprate);// set dcBlock at 3Hz
+            this->setSmoothingTime(20.f);
+            this->updateTail();
         }
         
         /**
@@ -34,12 +115,75 @@ namespace giml {
          */
         T processSample(T in) {
             if (!(this->enabled)) {return in;}
+            if (this->silence.isIdle() && this->silence.isSilent(in)) {
+                this->buffer.writeSilence(1);
+                this->feedback.skip(1);
+                this->blend.skip(1);
+                return in;
+            }
             
-            T readIndex = millisToSamples(this->delayTime, this->sampleRate); // calculate read index
-            T y_0 = loPass.lpf(this->buffer.readSample(readIndex)); // read from buffer and loPass
-            this->buffer.writeSample(this->dcBlock.hpf(in + giml::limit<T>(y_0 * this->feedback, 0.75))); // write sample to delay buffer
+            T out = this->process(in, this->feedback.next(), this->blend.next());
+            if (this->silence.isActive()) {
+                this->silence.update(this->silence.isSilent(in) && this->silence.isSilent(out), 1);
+            }
+            return out;
+        }
+
+        /**
+         * @brief Process a block of samples
+         * @param in input samples
+         * @param out output samples (may be the same as `in`)
+         * @param numSamples number of samples
+         */
+        void processBlock(const T* in, T* out, int numSamples) {
+            if (!(this->enabled)) {
+                ::memmove(out, in, numSamples * sizeof(T));
+                return;
+            }
+            bool silentIn = this->silence.isActive() && this->silence.isSilent(in, numSamples);
+            if (silentIn && this->silence.isIdle()) { // the echoes have died away, only the delay line moves on
+                ::memmove(out, in, numSamples * sizeof(T));
+                this->buffer.writeSilence(numSamples);
+                this->feedback.skip(numSamples);
+                this->blend.skip(numSamples);
+                return;
+            }
+            T feedbackBlock[SmoothedValue<T>::maxBlock], blendBlock[SmoothedValue<T>::maxBlock];
+            SmoothedValue<T>::forEachChunk(numSamples, [&](int start, int n) {
+                this->feedback.fillBlock(feedbackBlock, n);
+                this->blend.fillBlock(blendBlock, n);
+                for (int i = 0; i < n; i++) {
+                    out[start + i] = this->process(in[start + i], feedbackBlock[i], blendBlock[i]);
+                }
+            });
+            if (this->silence.isActive()) {
+                this->silence.update(silentIn && this->silence.isSilent(out, numSamples), numSamples);
+            }
+        }
+
+        /**
+         * @brief Lets the delay idle once its input and echoes are silent: silent blocks are then passed straight
+         * through without running the delay (the line is only filled with zeros, so a longer delay time set later
+         * can't bring back old audio), and the first block with sound wakes it again
+         * @param on whether to idle (off by default)
+         * @param thresholdDB level below which a sample counts as silent
+         */
+        void setIdleDetection(bool on, float thresholdDB = -90.f) {
+            this->silence.setActive(on, thresholdDB);
+        }
+
+        /**
+         * @return whether the delay is currently idling (see `setIdleDetection()`)
+         */
+        bool isIdle() const {
+            return this->silence.isIdle();
+        }
 
-          return giml::linMix<float>(in, y_0, this->blend); // return wet/dry mix
+        /**
+         * @return how long the echoes take to decay by 60dB, in seconds (`INFINITY` for feedback of 1 or more)
+         */
+        float getTailLength() override {
+            return this->tailSamples / this->sampleRate;
         }
 
         /**
@@ -47,7 +191,8 @@ namespace giml {
          * @param fbGain gain in linear amplitude. Be careful setting above 1!
          */
         void setFeedback(T fbGain) {
-            this->feedback = fbGain;
+            this->feedback.setTarget(fbGain);
+            this->updateTail();
         }
 
         /**
@@ -57,7 +202,8 @@ namespace giml {
         void setFeedback_t60(T timeMillis) {
             T normalizedDecay = millisToSamples(timeMillis, this->sampleRate) / 
             millisToSamples(this->delayTime, this->sampleRate);
-            this->feedback = giml::t60<T>(static_cast<int>(::round(normalizedDecay)));
+            this->feedback.setTarget(giml::t60<T>(static_cast<int>(::round(normalizedDecay))));
+            this->updateTail();
         }
 
         /**
@@ -67,6 +213,26 @@ namespace giml {
          */
         void setDelayTime(T sizeMillis) { 
             this->delayTime = giml::clip<T>(sizeMillis, 0, samplesToMillis(buffer.size(), this->sampleRate));
+            this->targetDelay = millisToSamples(this->delayTime, this->sampleRate);
+            this->updateTail();
+        }
+
+        /**
+         * @brief Set how delay time changes are smoothed
+         * @param mode `NONE`, `GLIDE` or `CROSSFADE`
+         * @param timeMillis glide time constant or crossfade length in milliseconds
+         */
+        void setSmoothing(SmoothingMode mode, T timeMillis = 50) {
+            this->smoothingMode = mode;
+            this->smoothingSamples = giml::millisToSamples(timeMillis, this->sampleRate);
+            if (this->smoothingSamples < 1) {
+                this->smoothingSamples = 1;
+            }
+            this->glideCoefficient = ::exp(-1.0 / this->smoothingSamples);
+            this->fadeIncrement = 1 / this->smoothingSamples;
+            this->currentDelay = this->fadeFrom = this->fadeTo = this->targetDelay; // start settled
+            this->fadePosition = 0;
+            this->updateTail();
         }
 
         /**
@@ -74,7 +240,16 @@ namespace giml {
          * @param gWet percentage of wet to blend in. Clipped to `[0,1]`
          */
         void setBlend(T gWet) { 
-            this->blend = giml::clip<T>(gWet, 0, 1);
+            this->blend.setTarget(giml::clip<T>(gWet, 0, 1));
+        }
+
+        /**
+         * @brief Sets the ramp time of feedback and blend (see `giml::SmoothedValue::setRampTime()`).
+         * The delay time has its own smoothing, see `setSmoothing()`
+         */
+        void setSmoothingTime(float rampMillis) {
+            this->feedback.setRampTime(rampMillis, this->sampleRate);
+            this->blend.setRampTime(rampMillis, this->sampleRate);
         }
         
         /**
@@ -3,7 +3,37 @@
 #include <math.h>
 #include "utility.hpp"
 #include "oscillator.hpp"
+#include "modbus.hpp"
 namespace giml {
+    /**
+     * @brief Lookup table for the gain window `sin(pi * phase)`, `phase` in `[0, 1]`,
+     * read with linear interpolation (max error ~2e-5)
+     */
+    template <typename T>
+    class HalfSineTable {
+    private:
+        static const int tableSize = 256;
+        T table[tableSize + 1]; // one guard point so interpolation never wraps
+
+    public:
+        HalfSineTable() {
+            for (int i = 0; i <= tableSize; i++) {
+                this->table[i] = ::sin(M_PI * i / tableSize);
+            }
+        }
+
+        /**
+         * @param phase in `[0, 1]`
+         * @return `sin(pi * phase)`
+         */
+        inline T operator()(T phase) const {
+            T x = phase * tableSize;
+            int i = giml::clip<int>(x, 0, tableSize - 1);
+            T frac = x - i;
+            return this->table[i] + frac * (this->table[i + 1] - this->table[i]);
+        }
+    };
+
     /**
      * @brief This class implements a time-domain pitchshifter 
      * @tparam T floating-point type for input and output sample data such as `float`, `double`, or `long double`,
@@ -14,14 +44,18 @@ namespace giml {
     private:
         int sampleRate;
         float pitchRatio = 1.f, windowSize = 22.f; 
+        float windowSamples; // windowSize in samples, updated by the setters
         giml::CircularBuffer<T> buffer;
         giml::Phasor<T> osc;
+        giml::ModTap<T> modTap; // replaces `osc` when connected, see `setModSource()`
+        giml::HalfSineTable<T> window;
 
     public:
         Detune() = delete;
         Detune(int samprate, float maxWindowMillis = 300.f) : sampleRate(samprate), osc(samprate) {
             this->osc.setFrequency(1000.f * ((1.f - this->pitchRatio) / this->windowSize));
             this->buffer.allocate(giml::millisToSamples(maxWindowMillis, samprate));
+            this->windowSamples = giml::millisToSamples(this->windowSize, samprate);
         }
 
         /**
@@ -36,19 +70,49 @@ namespace giml {
             if (!(this->enabled)) {
                 return in;
             }
-            T phase = this->osc.processSample();
-            float readIndex = phase * millisToSamples(this->windowSize, this->sampleRate); // readpoint 1
-            float readIndex2 = ::fmod(phase + 0.5f, 1) * millisToSamples(this->windowSize, this->sampleRate); // readpoint 2
+            T phase;
+            if (this->modTap.isConnected()) {
+                this->modTap.next();
+                phase = this->modTap.getPhase();
+            } else {
+                phase = this->osc.processSample();
+            }
+            T phase2 = phase + 0.5f; // second read head, half a cycle apart
+            if (phase2 >= 1) {phase2 -= 1;}
+            float readIndex = phase * this->windowSamples; // readpoint 1
+            float readIndex2 = phase2 * this->windowSamples; // readpoint 2
 
             T output = this->buffer.readSample(readIndex); // get sample
             T output2 = this->buffer.readSample(readIndex2); // get sample 2
 
-            T windowOne = ::cosf((phase - 0.5f) * M_PI); // gain windowing
-            T windowTwo = ::cosf((::fmod(phase + 0.5f, 1.f) - 0.5f) * M_PI);// ^
+            T windowOne = this->window(phase); // gain windowing, cos((phase - 0.5) * pi)
+            T windowTwo = this->window(phase2); // ^
             
             return output * windowOne + output2 * windowTwo; // windowed output
         }
 
+        /**
+         * @brief Process a block of samples
+         * @param in input samples
+         * @param out output samples (may be the same as `in`)
+         * @param numSamples number of samples
+         */
+        void processBlock(const T* in, T* out, int numSamples) {
+            for (int i = 0; i < numSamples; i++) {
+                out[i] = this->processSample(in[i]);
+            }
+        }
+
+        /**
+         * @brief Use a shared LFO from a `giml::ModBus` instead of `osc`. The source's phase sweeps the read heads,
+         * so its frequency sets the pitch change: `1000 * (1 - ratio) / windowSize` Hz (`setPitchRatio()` is ignored)
+         * @param bus bus to read from (`nullptr` goes back to `osc`)
+         * @param source index returned by `ModBus::addSource()`
+         */
+        void setModSource(const giml::ModBus<T>* bus, int source = 0) {
+            this->modTap.connect(bus, source);
+        }
+
         /**
          * @brief Set the pitch change ratio
          * @param ratio of desired pitch to input 
@@ -68,6 +132,8 @@ namespace giml {
                 sizeMillis = giml::samplesToMillis(this->buffer.size(), this->sampleRate);
             }
             this->windowSize = sizeMillis;
+            this->windowSamples = giml::millisToSamples(sizeMillis, this->sampleRate);
+            this->osc.setFrequency(1000.f * ((1.f - this->pitchRatio) / this->windowSize));
         }
     };
 }
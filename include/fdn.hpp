@@ -0,0 +1,268 @@
+#ifndef GIML_FDN_HPP
+#define GIML_FDN_HPP
+#include "utility.hpp"
+#include "reverb.hpp"
+namespace giml {
+    /**
+     * @brief Feedback Delay Network (FDN) Reverb Effect
+     *
+     * A cheaper alternative to `giml::Reverb`: instead of 20 combs + 4 nested APFs (36+ delay lines),
+     * `numDelayLines` (8 or 16) delay lines feed back into each other through a Hadamard matrix. The matrix
+     * mixes every line into every other line, which builds echo density much faster than parallel combs,
+     * so far fewer delay reads give a comparably dense tail.
+     *
+     * Uses the same room model as `giml::Reverb` (`giml::roomRT60()`) to pick the feedback gains
+     *
+     * @tparam T floating-point (float or double or long double)
+     */
+    template <typename T>
+    class FDNReverb : public Effect<T> {
+    private:
+        //The user-defined parameters
+        float param__time = 0.f; //Longest delay line (in seconds)
+        float param__regen = 0.f; //controls LPF feedback gains inside the delay lines
+        float param__damping = 0.f; //controls the output LPF gain
+        float param__length = 1.f; // controls volume of room and decay time of signal
+        float tailLength = 0.f; //seconds until the output has decayed by 60dB, see `getTailLength()`
+
+        int sampleRate;
+        int numDelayLines;
+        size_t lineLength = 0, writeIndex = 0;
+        T* pDelayLines = nullptr; //numDelayLines delay lines of lineLength samples, interleaved by time
+
+        //Per-line parameters and state (all in one allocation, see `allocate()`)
+        T* pParams = nullptr;
+        T *feedbackGain, *LPFFeedbackGain, *LPFLast,
+            *outputSign, //alternate the sign of each line in the output sum
+            *y; //scratch for the current sample
+        size_t* pDelaySamples = nullptr;
+        static const int numParams = 5;
+
+        T outputLPFLast = 0; //Damping LPF on the output
+
+        void allocate(int numLines, size_t length) {
+            this->release();
+            this->numDelayLines = numLines;
+            this->lineLength = length;
+            this->writeIndex = 0;
+            this->pDelayLines = (T*)::calloc(numLines * length, sizeof(T));
+            this->pParams = (T*)::calloc(numLines * numParams, sizeof(T));
+            this->pDelaySamples = (size_t*)::calloc(numLines, sizeof(size_t));
+            this->feedbackGain = this->pParams;
+            this->LPFFeedbackGain = this->feedbackGain + numLines;
+            this->LPFLast = this->LPFFeedbackGain + numLines;
+            this->outputSign = this->LPFLast + numLines;
+            this->y = this->outputSign + numLines;
+            for (int i = 0; i < numLines; i++) {
+                this->outputSign[i] = (i % 2) ? -1 : 1;
+                this->pDelaySamples[i] = 1;
+            }
+        }
+
+        void release() {
+            ::free(this->pDelayLines);
+            ::free(this->pParams);
+            ::free(this->pDelaySamples);
+            this->pDelayLines = nullptr;
+            this->pParams = nullptr;
+            this->pDelaySamples = nullptr;
+        }
+
+        void copyFrom(const FDNReverb<T>& r) {
+            this->enabled = r.enabled;
+            this->param__time = r.param__time;
+            this->param__regen = r.param__regen;
+            this->param__damping = r.param__damping;
+            this->param__length = r.param__length;
+            this->tailLength = r.tailLength;
+            this->sampleRate = r.sampleRate;
+            this->outputLPFLast = r.outputLPFLast;
+
+            this->allocate(r.numDelayLines, r.lineLength);
+            this->writeIndex = r.writeIndex;
+            ::memcpy(this->pDelayLines, r.pDelayLines, r.numDelayLines * r.lineLength * sizeof(T));
+            ::memcpy(this->pParams, r.pParams, r.numDelayLines * numParams * sizeof(T));
+            ::memcpy(this->pDelaySamples, r.pDelaySamples, r.numDelayLines * sizeof(size_t));
+        }
+
+        /**
+         * @brief In-place fast Walsh-Hadamard transform, normalized so that the feedback matrix is orthogonal
+         * (energy preserving, so the feedback gains alone decide the decay). N log N adds instead of an N^2
+         * matrix multiply, and each stage is a loop of independent butterflies that vectorizes
+         * @param v `numDelayLines` values
+         */
+        void hadamard(T* v) const {
+            for (int h = 1; h < this->numDelayLines; h *= 2) {
+                for (int i = 0; i < this->numDelayLines; i += 2 * h) {
+                    for (int j = i; j < i + h; j++) {
+                        T a = v[j], b = v[j + h];
+                        v[j] = a + b;
+                        v[j + h] = a - b;
+                    }
+                }
+            }
+            T norm = 1 / ::sqrt((T)this->numDelayLines);
+            for (int i = 0; i < this->numDelayLines; i++) {
+                v[i] *= norm;
+            }
+        }
+
+    public:
+        using RoomType = giml::RoomType;
+
+        //Constructor
+        FDNReverb() = delete;
+        /**
+         * @param sampleRate sample rate of your project
+         * @param numDelayLines number of delay lines, rounded up to a power of 2 (8 or 16 recommended)
+         * @param maxTime longest allowed delay line in seconds
+         */
+        FDNReverb(int sampleRate, int numDelayLines = 8, float maxTime = 1.f) : sampleRate(sampleRate) {
+            int numLines = 1;
+            while (numLines < numDelayLines) {
+                numLines *= 2; // Hadamard matrices need a power of 2
+            }
+            if (numLines != numDelayLines) {
+                printf("FDNReverb needs a power of 2 delay lines, rounding up\n");
+            }
+            this->allocate(numLines, maxTime * sampleRate + 1);
+        }
+        //Copy constructor
+        FDNReverb(const FDNReverb<T>& r) {
+            this->copyFrom(r);
+        }
+        //Copy assignment operator
+        FDNReverb<T>& operator=(const FDNReverb<T>& r) {
+            if (this != &r) {
+                this->copyFrom(r);
+            }
+            return *this;
+        }
+        //Destructor
+        ~FDNReverb() {
+            this->release();
+        }
+
+        /**
+         * @brief Set the reverb parameters, same meaning as `giml::Reverb::setParams()`
+         *
+         * @param time Longest delay line in seconds (the rest are spread down to 2/3 of it)
+         * @param regen [0, 1) feedback gain of the LPFs inside the delay lines, adds depth to your sound
+         * @param damping [0, 1) feedback gain of the output LPF to dampen the high frequencies
+         * @param roomLength Length parameter in feet of room (affects space according to room shape chosen)
+         * @param absorptionCoefficient [0, 1] How much the walls of the room absorb sound (0 for complete reflection, 1 for complete absorption)
+         * @param roomType Preset shape of room for volume/surface area calculations
+         */
+        void setParams(float time, float regen, float damping, float roomLength = 1.f, float absorptionCoefficient = 0.75f, RoomType roomType = RoomType::SPHERE) {
+            this->setTime(time);
+            this->setRoom(roomLength, absorptionCoefficient, roomType); //Feedback gains first, the LPF gains depend on them
+            this->setRegen(regen);
+            this->setDamping(damping);
+        }
+
+        /**
+         * @brief Function to process one sound sample through the `FDNReverb` effect at a time
+         *
+         * @param in floating-point type input
+         * @return T floating-point (float or double) output
+         */
+        T processSample(T in) {
+            if (!(this->enabled)) {
+                return in;
+            }
+
+            //Read every delay line, sum the output and run the in-loop LPFs
+            T summedValue = 0;
+            for (int i = 0; i < this->numDelayLines; i++) {
+                long int readIndex = this->writeIndex - this->pDelaySamples[i];
+                readIndex += (readIndex < 0) ? this->lineLength : 0; // circular logic
+                T yn = this->pDelayLines[readIndex * this->numDelayLines + i];
+                summedValue += this->outputSign[i] * yn;
+
+                T filtered = giml::undenormalize(yn + this->LPFLast[i] * this->LPFFeedbackGain[i]);
+                this->LPFLast[i] = filtered;
+                this->y[i] = filtered * this->feedbackGain[i];
+            }
+
+            //Mix every line into every other line and write the new frame
+            this->hadamard(this->y);
+            T* frame = this->pDelayLines + this->writeIndex * this->numDelayLines;
+            for (int i = 0; i < this->numDelayLines; i++) {
+                frame[i] = giml::undenormalize(in + this->y[i]);
+            }
+            this->writeIndex++;
+            if (this->writeIndex >= this->lineLength) {
+                this->writeIndex = 0; // circular logic
+            }
+
+            summedValue /= this->numDelayLines; //Need to add this to make sure our signal stays within bounds
+            this->outputLPFLast = giml::undenormalize(summedValue * (1 - this->param__damping) + this->param__damping * this->outputLPFLast);
+            return this->outputLPFLast;
+        }
+
+        /**
+         * @return how long the slowest delay line takes to decay by 60dB (longer than the room's RT60 with regen), in seconds
+         */
+        float getTailLength() override {
+            return this->tailLength;
+        }
+
+    private:
+        /**
+         * @brief Spreads the delay line lengths the same way `Reverb::setTime()` spreads its comb filters
+         * @param t time in seconds
+         */
+        void setTime(float t) {
+            this->param__time = t;
+            float* delays = (float*)::calloc(this->numDelayLines, sizeof(float));
+            giml::spreadDelayTimes(this->sampleRate * t, this->numDelayLines, delays);
+            for (int i = 0; i < this->numDelayLines; i++) {
+                size_t d = ::round(delays[i]);
+                this->pDelaySamples[i] = giml::clip<size_t>(d, 1, this->lineLength - 1);
+            }
+            ::free(delays);
+        }
+
+        /**
+         * @brief Calculates each line's feedback gain from the room's RT-60 (see `giml::roomRT60()`)
+         */
+        void setRoom(float length, float absorptionCoefficient, RoomType type) {
+            if (length < 0) {
+                length = 0;
+            }
+            this->param__length = length;
+            float RT60 = giml::roomRT60(length, absorptionCoefficient, type);
+            for (int i = 0; i < this->numDelayLines; i++) {
+                this->feedbackGain[i] = giml::rt60FeedbackGain(this->pDelaySamples[i], this->sampleRate, RT60);
+            }
+        }
+
+        /**
+         * @brief Sets the in-loop LPF gains the same way `Reverb::calculateRegen()` does for its comb filters:
+         * lpf_G = regen(1-g), which keeps the loop gain below 1. Then updates the tail length, which depends on both
+         * @param regen [0, 1)
+         */
+        void setRegen(float regen) {
+            regen = giml::clip<float>(regen, 0, 0.999999);
+            this->param__regen = regen;
+            this->tailLength = 0.f;
+            for (int i = 0; i < this->numDelayLines; i++) {
+                this->LPFFeedbackGain[i] = regen * (1 - ::fabs(this->feedbackGain[i]));
+                //The slowest line decides the tail: its LPF raises the loop gain at DC to g/(1-lpf_G)
+                float loopGain = this->feedbackGain[i] / (1 - this->LPFFeedbackGain[i]);
+                float decay = (float)this->pDelaySamples[i] / this->sampleRate
+                    + giml::feedbackRT60(this->pDelaySamples[i], this->sampleRate, loopGain);
+                this->tailLength = (decay > this->tailLength) ? decay : this->tailLength;
+            }
+        }
+
+        /**
+         * @brief Sets the output LPF gain
+         * @param g [0, 1)
+         */
+        void setDamping(float g) {
+            this->param__damping = giml::clip<float>(g, 0, 0.97f);
+        }
+    };
+}
+#endif
@@ -0,0 +1,305 @@
+#ifndef GIML_FFT_HPP
+#define GIML_FFT_HPP
+#include "utility.hpp"
+namespace giml {
+    /**
+     * @brief Fast Fourier Transform for power-of-two sizes, complex and real.
+     *
+     * Real and imaginary parts are kept in separate arrays. Everything the transforms need (twiddle factors,
+     * bit-reversal permutations, scratch) is allocated in `prepare()`, nothing is allocated afterwards.
+     *
+     * The butterflies run two radix-2 stages per pass over the data (radix-4), with an extra radix-2 pass
+     * when the size is an odd power of 2. Twiddles are stored per stage so that the innermost loop reads
+     * every array contiguously and can be vectorized by the compiler.
+     *
+     * A real transform of size N is done with one complex transform of size N/2 plus an O(N) split step.
+     *
+     * @tparam T floating-point type
+     */
+    template <typename T>
+    class FFT {
+    private:
+        int size = 0, log2Size = 0;
+        //Twiddles for every stage: the stage that combines halves of size h reads h values starting at h - 1
+        T* pTwiddleRe = nullptr;
+        T* pTwiddleIm = nullptr;
+        T* pRealTwiddleRe = nullptr; //exp(-2pi i k/size) for k < size/2, used by the real transforms
+        T* pRealTwiddleIm = nullptr;
+        int* pBitReverse = nullptr; //Permutation for size
+        int* pHalfBitReverse = nullptr; //Permutation for size/2 (real transforms)
+        T* pScratchRe = nullptr; //size/2 scratch for inverseReal()
+        T* pScratchIm = nullptr;
+
+        void release() {
+            ::free(this->pTwiddleRe);
+            ::free(this->pTwiddleIm);
+            ::free(this->pRealTwiddleRe);
+            ::free(this->pRealTwiddleIm);
+            ::free(this->pBitReverse);
+            ::free(this->pHalfBitReverse);
+            ::free(this->pScratchRe);
+            ::free(this->pScratchIm);
+            this->pTwiddleRe = this->pTwiddleIm = this->pRealTwiddleRe = this->pRealTwiddleIm = nullptr;
+            this->pScratchRe = this->pScratchIm = nullptr;
+            this->pBitReverse = this->pHalfBitReverse = nullptr;
+            this->size = this->log2Size = 0;
+        }
+
+        static void fillBitReverse(int* table, int n, int log2n) {
+            for (int i = 0; i < n; i++) {
+                int reversed = 0;
+                for (int b = 0; b < log2n; b++) {
+                    reversed |= ((i >> b) & 1) << (log2n - 1 - b);
+                }
+                table[i] = reversed;
+            }
+        }
+
+        /**
+         * @brief In-place forward decimation-in-time transform of `n` points (`n` a power of 2, at most `size`)
+         */
+        void transform(T* re, T* im, int n, int log2n, const int* bitReverse) const {
+            // Put the input in bit-reversed order
+            for (int i = 0; i < n; i++) {
+                int j = bitReverse[i];
+                if (i < j) {
+                    T tempRe = re[i], tempIm = im[i];
+                    re[i] = re[j];
+                    im[i] = im[j];
+                    re[j] = tempRe;
+                    im[j] = tempIm;
+                }
+            }
+
+            int h = 1;
+            if (log2n % 2) { // One radix-2 pass first when the size is an odd power of 2 (all twiddles are 1)
+                for (int a = 0; a < n; a += 2) {
+                    T bRe = re[a + 1], bIm = im[a + 1];
+                    re[a + 1] = re[a] - bRe;
+                    im[a + 1] = im[a] - bIm;
+                    re[a] += bRe;
+                    im[a] += bIm;
+                }
+                h = 2;
+            }
+
+            // Radix-4 passes: combine the radix-2 stages for halves of size h and 2h in one pass
+            for (; h < n; h *= 4) {
+                const T* w1Re = this->pTwiddleRe + h - 1; // exp(-pi i k/h)
+                const T* w1Im = this->pTwiddleIm + h - 1;
+                const T* w2Re = this->pTwiddleRe + 2 * h - 1; // exp(-pi i k/2h)
+                const T* w2Im = this->pTwiddleIm + 2 * h - 1;
+                for (int start = 0; start < n; start += 4 * h) {
+                    T* re0 = re + start; T* im0 = im + start;
+                    T* re1 = re0 + h; T* im1 = im0 + h;
+                    T* re2 = re1 + h; T* im2 = im1 + h;
+                    T* re3 = re2 + h; T* im3 = im2 + h;
+                    for (int k = 0; k < h; k++) {
+                        // First stage: (0, 1) and (2, 3) with exp(-pi i k/h)
+                        T tRe = re1[k] * w1Re[k] - im1[k] * w1Im[k];
+                        T tIm = re1[k] * w1Im[k] + im1[k] * w1Re[k];
+                        T b0Re = re0[k] + tRe, b0Im = im0[k] + tIm;
+                        T b1Re = re0[k] - tRe, b1Im = im0[k] - tIm;
+                        tRe = re3[k] * w1Re[k] - im3[k] * w1Im[k];
+                        tIm = re3[k] * w1Im[k] + im3[k] * w1Re[k];
+                        T b2Re = re2[k] + tRe, b2Im = im2[k] + tIm;
+                        T b3Re = re2[k] - tRe, b3Im = im2[k] - tIm;
+
+                        // Second stage: (0, 2) with exp(-pi i k/2h) and (1, 3) with exp(-pi i (k+h)/2h) = -i exp(-pi i k/2h)
+                        tRe = b2Re * w2Re[k] - b2Im * w2Im[k];
+                        tIm = b2Re * w2Im[k] + b2Im * w2Re[k];
+                        re0[k] = b0Re + tRe; im0[k] = b0Im + tIm;
+                        re2[k] = b0Re - tRe; im2[k] = b0Im - tIm;
+                        T uRe = b3Re * w2Re[k] - b3Im * w2Im[k];
+                        T uIm = b3Re * w2Im[k] + b3Im * w2Re[k];
+                        tRe = uIm; // -i * u
+                        tIm = -uRe;
+                        re1[k] = b1Re + tRe; im1[k] = b1Im + tIm;
+                        re3[k] = b1Re - tRe; im3[k] = b1Im - tIm;
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief The inverse transform is the forward transform of the conjugate, conjugated and scaled
+         */
+        void inverseTransform(T* re, T* im, int n, int log2n, const int* bitReverse) const {
+            for (int i = 0; i < n; i++) {
+                im[i] = -im[i];
+            }
+            this->transform(re, im, n, log2n, bitReverse);
+            T scale = T(1) / n;
+            for (int i = 0; i < n; i++) {
+                re[i] *= scale;
+                im[i] *= -scale;
+            }
+        }
+
+    public:
+        FFT() {}
+        FFT(int size) {
+            this->prepare(size);
+        }
+        //Copy constructor
+        FFT(const FFT<T>& f) {
+            if (f.size > 0) {
+                this->prepare(f.size);
+            }
+        }
+        //Copy assignment operator
+        FFT<T>& operator=(const FFT<T>& f) {
+            if (this != &f) {
+                this->release();
+                if (f.size > 0) {
+                    this->prepare(f.size);
+                }
+            }
+            return *this;
+        }
+        ~FFT() {
+            this->release();
+        }
+
+        /**
+         * @brief Allocates and precomputes everything the transforms need
+         * @param fftSize transform size, must be a power of 2 (at least 4 for the real transforms)
+         */
+        void prepare(int fftSize) {
+            this->release();
+            int log2 = 1;
+            while ((1 << log2) < fftSize) {
+                log2++;
+            }
+            if ((1 << log2) != fftSize) {
+                printf("FFT size must be a power of 2, rounding up\n");
+            }
+            this->log2Size = log2;
+            this->size = 1 << log2;
+
+            this->pTwiddleRe = (T*)::calloc(this->size, sizeof(T));
+            this->pTwiddleIm = (T*)::calloc(this->size, sizeof(T));
+            for (int h = 1; h < this->size; h *= 2) {
+                for (int k = 0; k < h; k++) {
+                    this->pTwiddleRe[h - 1 + k] = ::cos(M_PI * k / h);
+                    this->pTwiddleIm[h - 1 + k] = -::sin(M_PI * k / h);
+                }
+            }
+
+            int half = this->size / 2;
+            this->pRealTwiddleRe = (T*)::calloc(half, sizeof(T));
+            this->pRealTwiddleIm = (T*)::calloc(half, sizeof(T));
+            for (int k = 0; k < half; k++) {
+                this->pRealTwiddleRe[k] = ::cos(M_2PI * k / this->size);
+                this->pRealTwiddleIm[k] = -::sin(M_2PI * k / this->size);
+            }
+
+            this->pBitReverse = (int*)::calloc(this->size, sizeof(int));
+            this->pHalfBitReverse = (int*)::calloc(half, sizeof(int));
+            fillBitReverse(this->pBitReverse, this->size, this->log2Size);
+            fillBitReverse(this->pHalfBitReverse, half, this->log2Size - 1);
+
+            this->pScratchRe = (T*)::calloc(half, sizeof(T));
+            this->pScratchIm = (T*)::calloc(half, sizeof(T));
+        }
+
+        int getSize() const {
+            return this->size;
+        }
+
+        /**
+         * @brief Number of bins produced by `forwardReal()` (`getSize()/2 + 1`)
+         */
+        int getNumBins() const {
+            return this->size / 2 + 1;
+        }
+
+        /**
+         * @brief In-place forward complex transform (unnormalized)
+         * @param re real parts, `getSize()` values
+         * @param im imaginary parts, `getSize()` values
+         */
+        void forward(T* re, T* im) const {
+            this->transform(re, im, this->size, this->log2Size, this->pBitReverse);
+        }
+
+        /**
+         * @brief In-place inverse complex transform, scaled by `1/getSize()` so that `inverse(forward(x)) = x`
+         * @param re real parts, `getSize()` values
+         * @param im imaginary parts, `getSize()` values
+         */
+        void inverse(T* re, T* im) const {
+            this->inverseTransform(re, im, this->size, this->log2Size, this->pBitReverse);
+        }
+
+        /**
+         * @brief Forward transform of a real signal (unnormalized). Only bins 0 to `getSize()/2` are output,
+         * the rest are their complex conjugates
+         * @param in `getSize()` real samples
+         * @param re real parts, `getNumBins()` values
+         * @param im imaginary parts, `getNumBins()` values
+         */
+        void forwardReal(const T* in, T* re, T* im) const {
+            // Pack even samples into the real parts and odd samples into the imaginary parts of a half-size signal
+            int half = this->size / 2;
+            for (int n = 0; n < half; n++) {
+                re[n] = in[2 * n];
+                im[n] = in[2 * n + 1];
+            }
+            this->transform(re, im, half, this->log2Size - 1, this->pHalfBitReverse);
+
+            // Split: X[k] = E[k] + exp(-2pi i k/N) O[k] where E and O are the spectra of the even and odd samples
+            // E[k] = (Z[k] + conj(Z[N/2-k]))/2, O[k] = (Z[k] - conj(Z[N/2-k]))/2i
+            T z0Re = re[0], z0Im = im[0];
+            re[0] = z0Re + z0Im;
+            im[0] = 0;
+            re[half] = z0Re - z0Im;
+            im[half] = 0;
+            for (int k = 1; k <= half / 2; k++) {
+                int j = half - k;
+                T eRe = (re[k] + re[j]) / 2, eIm = (im[k] - im[j]) / 2;
+                T oRe = (im[k] + im[j]) / 2, oIm = (re[j] - re[k]) / 2;
+                T wRe = this->pRealTwiddleRe[k], wIm = this->pRealTwiddleIm[k];
+                T tRe = oRe * wRe - oIm * wIm, tIm = oRe * wIm + oIm * wRe;
+                re[k] = eRe + tRe;
+                im[k] = eIm + tIm;
+                // E and O are conjugate symmetric and exp(-2pi i j/N) = -conj(exp(-2pi i k/N)), so X[j] = conj(E[k] - t)
+                re[j] = eRe - tRe;
+                im[j] = tIm - eIm;
+            }
+        }
+
+        /**
+         * @brief Inverse of `forwardReal()`, scaled so that `inverseReal(forwardReal(x)) = x`
+         * @param re real parts, `getNumBins()` values
+         * @param im imaginary parts, `getNumBins()` values (the imaginary parts of bins 0 and `getSize()/2` are ignored)
+         * @param out `getSize()` real samples
+         */
+        void inverseReal(const T* re, const T* im, T* out) {
+            // Rebuild the half-size spectrum Z[k] = E[k] + i O[k]
+            // E[k] = (X[k] + conj(X[N/2-k]))/2, O[k] = exp(2pi i k/N) (X[k] - conj(X[N/2-k]))/2
+            int half = this->size / 2;
+            T* zRe = this->pScratchRe;
+            T* zIm = this->pScratchIm;
+            for (int k = 0; k < half; k++) {
+                int j = half - k;
+                T eRe = (re[k] + re[j]) / 2, eIm = (im[k] - im[j]) / 2;
+                T dRe = (re[k] - re[j]) / 2, dIm = (im[k] + im[j]) / 2;
+                if (k == 0) {
+                    eIm = 0;
+                    dIm = 0;
+                }
+                T wRe = this->pRealTwiddleRe[k], wIm = -this->pRealTwiddleIm[k];
+                T oRe = dRe * wRe - dIm * wIm, oIm = dRe * wIm + dIm * wRe;
+                zRe[k] = eRe - oIm;
+                zIm[k] = eIm + oRe;
+            }
+            this->inverseTransform(zRe, zIm, half, this->log2Size - 1, this->pHalfBitReverse);
+            for (int n = 0; n < half; n++) {
+                out[2 * n] = zRe[n];
+                out[2 * n + 1] = zIm[n];
+            }
+        }
+    };
+}
+#endif
@@ -11,14 +11,44 @@ namespace giml {
     T a = 0;
     T y_1 = 0; 
 
+    /**
+     * @brief Number of samples the block kernels solve at once. 
+     * Chosen to match a 4-lane SIMD register (SSE/NEON floats, AVX doubles)
+     */
+    static const int kernelSize = 4;
+    T inputKernel[kernelSize][kernelSize] = {}; // inputKernel[j][k] = (1-a) * a^(k-j) for k >= j, 0 otherwise
+    T stateKernel[kernelSize] = {}; // stateKernel[k] = a^(k+1)
+    bool kernelDirty = true; // recalculated lazily so per-sample `setG()`/`setCutoff()` calls stay cheap
+
+    /**
+     * @brief Unrolls the recurrence `kernelSize` steps so that `y[n..n+3]` depend only on 
+     * `x[n..n+3]` and `y[n-1]` (state-space/scan form). Called by the block functions after `a` changes
+     */
+    void updateKernel() {
+      T aPow[kernelSize + 1]; // aPow[k] = a^k
+      aPow[0] = 1;
+      for (int k = 1; k <= kernelSize; k++) {
+        aPow[k] = aPow[k - 1] * this->a;
+      }
+      for (int k = 0; k < kernelSize; k++) {
+        for (int j = 0; j < kernelSize; j++) {
+          this->inputKernel[j][k] = (j > k) ? 0 : (1 - this->a) * aPow[k - j];
+        }
+        this->stateKernel[k] = aPow[k + 1];
+      }
+      this->kernelDirty = false;
+    }
+
   public:
+    onePole() {}
+
     /**
      * @brief loPass config: `y_0 = (x_0 * (1-a)) + (y_1 * a)`
      * @param in input sample
      * @return `in * (1-a) + y_1 * a`
      */
     T lpf(T in) {
-      this->y_1 = giml::linMix(in, y_1, a);
+      this->y_1 = giml::undenormalize(giml::linMix(in, y_1, a));
       return y_1;
     }
 
@@ -32,6 +62,62 @@ namespace giml {
       return in - this->y_1;
     }
 
+    /**
+     * @brief Block version of `lpf()`. Solves 4 consecutive samples at a time as a small matrix-vector
+     * product (see `updateKernel()`), so the work within a group is independent and maps onto SIMD lanes 
+     * instead of waiting on the previous output every sample
+     * @param in input samples
+     * @param out output samples (may be the same array as `in`)
+     * @param numSamples number of samples to process
+     */
+    void lpf(const T* in, T* out, int numSamples) {
+      if (this->kernelDirty) {
+        this->updateKernel();
+      }
+      int i = 0;
+      for (; i + kernelSize <= numSamples; i += kernelSize) {
+        T y[kernelSize];
+        for (int k = 0; k < kernelSize; k++) {
+          y[k] = this->stateKernel[k] * this->y_1;
+        }
+        for (int j = 0; j < kernelSize; j++) {
+          for (int k = 0; k < kernelSize; k++) {
+            y[k] += this->inputKernel[j][k] * in[i + j];
+          }
+        }
+        for (int k = 0; k < kernelSize; k++) {
+          out[i + k] = y[k];
+        }
+        this->y_1 = giml::undenormalize(y[kernelSize - 1]);
+      }
+      for (; i < numSamples; i++) { // leftover samples
+        out[i] = this->lpf(in[i]);
+      }
+    }
+
+    /**
+     * @brief Block version of `hpf()`, see `lpf(const T*, T*, int)`
+     * @param in input samples
+     * @param out output samples (may be the same array as `in`)
+     * @param numSamples number of samples to process
+     */
+    void hpf(const T* in, T* out, int numSamples) {
+      int i = 0;
+      for (; i + kernelSize <= numSamples; i += kernelSize) {
+        T x[kernelSize], y[kernelSize];
+        for (int k = 0; k < kernelSize; k++) {
+          x[k] = in[i + k]; // copy in case `in` and `out` alias
+        }
+        this->lpf(x, y, kernelSize);
+        for (int k = 0; k < kernelSize; k++) {
+          out[i + k] = x[k] - y[k];
+        }
+      }
+      for (; i < numSamples; i++) { // leftover samples
+        out[i] = this->hpf(in[i]);
+      }
+    }
+
     /**
      * @brief Set filter coefficient by specifying a cutoff frequency and sample rate.
      * See Generating Sound & Organizing Time I - Wakefield and Taylor 2022 Chapter 6 pg. 166
@@ -42,6 +128,7 @@ namespace giml {
       Hz = giml::clip<T>(::abs(Hz), 0, sampleRate / 2);
       Hz *= -M_2PI / sampleRate;
       this->a = ::pow(M_E, Hz);
+      this->kernelDirty = true;
     }
 
    /**
@@ -50,6 +137,104 @@ namespace giml {
     */
     void setG(T aVal) {
       this->a = giml::clip<T>(aVal, 0, 1);
+      this->kernelDirty = true;
+    }
+  };
+
+  /**
+   * @brief A bank of `Lanes` independent one-pole filters (one per mono stream), 
+   * stored structure-of-arrays so that every lane advances in one SIMD instruction sequence
+   * @tparam T floating-point type for input and output sample data
+   * @tparam Lanes number of streams processed together
+   */
+  template <typename T, int Lanes = 8>
+  class OnePoleBank {
+  private:
+    static_assert(Lanes > 0, "OnePoleBank needs at least one lane");
+    T a[Lanes] = {};
+    T y_1[Lanes] = {};
+
+  public:
+    /**
+     * @brief loPass config for every lane: `y_0 = (x_0 * (1-a)) + (y_1 * a)`
+     * @param in `Lanes` input samples, one per stream
+     * @param out `Lanes` output samples, one per stream (may be the same array as `in`)
+     */
+    void lpf(const T* in, T* out) {
+      for (int i = 0; i < Lanes; i++) {
+        this->y_1[i] = giml::undenormalize(in[i] * (1 - this->a[i]) + this->y_1[i] * this->a[i]);
+        out[i] = this->y_1[i];
+      }
+    }
+
+    /**
+     * @brief hiPass config for every lane: `y_0 = x_0 - lpf(x_0)`
+     * @param in `Lanes` input samples, one per stream
+     * @param out `Lanes` output samples, one per stream (may be the same array as `in`)
+     */
+    void hpf(const T* in, T* out) {
+      for (int i = 0; i < Lanes; i++) {
+        this->y_1[i] = giml::undenormalize(in[i] * (1 - this->a[i]) + this->y_1[i] * this->a[i]);
+        out[i] = in[i] - this->y_1[i];
+      }
+    }
+
+    /**
+     * @brief Block version of `lpf()` for interleaved frames (`in[frame * Lanes + lane]`)
+     * @param in interleaved input samples
+     * @param out interleaved output samples (may be the same array as `in`)
+     * @param numFrames number of frames to process
+     */
+    void lpf(const T* in, T* out, int numFrames) {
+      for (int n = 0; n < numFrames; n++) {
+        this->lpf(in + n * Lanes, out + n * Lanes);
+      }
+    }
+
+    /**
+     * @brief Block version of `hpf()` for interleaved frames (`in[frame * Lanes + lane]`)
+     * @param in interleaved input samples
+     * @param out interleaved output samples (may be the same array as `in`)
+     * @param numFrames number of frames to process
+     */
+    void hpf(const T* in, T* out, int numFrames) {
+      for (int n = 0; n < numFrames; n++) {
+        this->hpf(in + n * Lanes, out + n * Lanes);
+      }
+    }
+
+    /**
+     * @brief Set one lane's coefficient from a cutoff frequency, see `giml::onePole::setCutoff()`
+     * @param lane index in `[0, Lanes)`
+     * @param Hz cutoff frequency in Hz
+     * @param sampleRate project sample rate
+     */
+    void setCutoff(int lane, T Hz, T sampleRate) {
+      Hz = giml::clip<T>(::abs(Hz), 0, sampleRate / 2);
+      Hz *= -M_2PI / sampleRate;
+      this->setG(lane, ::pow(M_E, Hz));
+    }
+
+    /**
+     * @brief set one lane's coefficient manually
+     * @param lane index in `[0, Lanes)`
+     * @param aVal desired coefficient. 0 = bypass, 1 = sustain
+     */
+    void setG(int lane, T aVal) {
+      if (lane < 0 || lane >= Lanes) {
+        printf("OnePoleBank lane out of bounds\n");
+        return;
+      }
+      this->a[lane] = giml::clip<T>(aVal, 0, 1);
+    }
+
+    /**
+     * @brief Clears the state of every lane
+     */
+    void reset() {
+      for (int i = 0; i < Lanes; i++) {
+        this->y_1[i] = 0;
+      }
     }
   };
 }
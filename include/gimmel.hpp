@@ -1,12 +1,25 @@
+#include "automation.hpp"
 #include "biquad.hpp"
 #include "chorus.hpp"
 #include "compressor.hpp"
+#include "convolution.hpp"
 #include "delay.hpp"
+#include "denormals.hpp"
 #include "detune.hpp"
+#include "fdn.hpp"
+#include "fft.hpp"
 #include "filter.hpp"
+#include "harmonizer.hpp"
+#include "modbus.hpp"
+#include "multitapdelay.hpp"
 #include "oscillator.hpp"
+#include "oscillatorbank.hpp"
+#include "parameterqueue.hpp"
 #include "phaser.hpp"
+#include "pitchshifter.hpp"
 #include "reverb.hpp"
 #include "saturation.hpp"
+#include "stft.hpp"
 #include "tremolo.hpp"
-#include "utility.hpp"
\ No newline at end of file
+#include "utility.hpp"
+#include "wavetableosc.hpp"
\ No newline at end of file
@@ -0,0 +1,235 @@
+#ifndef GIML_HARMONIZER_HPP
+#define GIML_HARMONIZER_HPP
+#include "utility.hpp"
+namespace giml {
+    /**
+     * @brief This class implements several `giml::Detune` voices reading from one shared delay line
+     *
+     * Each voice is a pair of read heads half a cycle apart, swept by its own phasor and crossfaded with
+     * `sin(pi * phase)` gain windows, exactly like `giml::Detune`. The input is written once, and the voices'
+     * parameters and state are stored structure-of-arrays so the phase, window and read-position math for
+     * all voices runs as one vectorizable loop; only the buffer reads are per voice.
+     *
+     * @tparam T floating-point type for input and output sample data such as `float`, `double`, or `long double`
+     */
+    template <typename T>
+    class Harmonizer : public Effect<T> {
+    private:
+        int sampleRate;
+        int numVoices;
+
+        T* pBuffer = nullptr;
+        size_t bufferSize = 0, writeIndex = 0; //bufferSize is a power of 2 so indices wrap with a mask
+        int mask = 0;
+        float maxWindowSamples;
+
+        //Per-voice parameters and state (all in one allocation, see `allocate()`)
+        T* pParams = nullptr;
+        T *pitchRatio, *windowSize, //user parameters (windowSize in ms)
+            *windowSamples, *phaseIncrement, *gain,
+            *phase,
+            *delay1, *delay2, *window1, *window2; //scratch for the current sample
+        static const int numParams = 10;
+
+        void allocate(int voices, size_t size) {
+            this->release();
+            this->numVoices = voices;
+            this->bufferSize = 1;
+            while (this->bufferSize < size) {
+                this->bufferSize *= 2;
+            }
+            this->mask = this->bufferSize - 1;
+            this->writeIndex = 0;
+            this->pBuffer = (T*)::calloc(this->bufferSize, sizeof(T));
+            this->pParams = (T*)::calloc(voices * numParams, sizeof(T));
+            T* p = this->pParams;
+            T** arrays[numParams] = {&this->pitchRatio, &this->windowSize, &this->windowSamples, &this->phaseIncrement,
+                &this->gain, &this->phase, &this->delay1, &this->delay2, &this->window1, &this->window2};
+            for (int i = 0; i < numParams; i++) {
+                *arrays[i] = p + i * voices;
+            }
+        }
+
+        void release() {
+            ::free(this->pBuffer);
+            ::free(this->pParams);
+            this->pBuffer = this->pParams = nullptr;
+        }
+
+        void copyFrom(const Harmonizer<T>& h) {
+            this->enabled = h.enabled;
+            this->sampleRate = h.sampleRate;
+            this->maxWindowSamples = h.maxWindowSamples;
+            this->allocate(h.numVoices, h.bufferSize);
+            this->writeIndex = h.writeIndex;
+            ::memcpy(this->pBuffer, h.pBuffer, h.bufferSize * sizeof(T));
+            ::memcpy(this->pParams, h.pParams, h.numVoices * numParams * sizeof(T));
+        }
+
+        /**
+         * @brief Same phasor frequency as `Detune::setPitchRatio()`, as a signed phase increment
+         */
+        void updateVoice(int voice) {
+            this->windowSamples[voice] = giml::millisToSamples(this->windowSize[voice], this->sampleRate);
+            this->phaseIncrement[voice] = 1000.f * ((1.f - this->pitchRatio[voice]) / this->windowSize[voice]) / this->sampleRate;
+        }
+
+        bool checkVoice(int voice) const {
+            if (voice < 0 || voice >= this->numVoices) {
+                printf("Harmonizer voice out of bounds\n");
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief `sin(pi * x)` for `x` in `[0, 1]` as a polynomial in `(x - 0.5)^2` (max error ~3e-5 in float). Unlike a table
+         * lookup it needs no gather, so the window loop stays vectorizable
+         */
+        static inline T halfSine(T x) {
+            T u = (x - T(0.5)) * T(M_PI);
+            T u2 = u * u;
+            return T(1) + u2 * (T(-1.0 / 2) + u2 * (T(1.0 / 24) + u2 * (T(-1.0 / 720) + u2 * T(1.0 / 40320))));
+        }
+
+        /**
+         * @brief Linearly interpolated read `delayInSamples` behind the sample at `newest`
+         */
+        inline T read(int newest, T delayInSamples) const {
+            int d = (int)delayInSamples; // int conversion is a single instruction, size_t isn't
+            T frac = delayInSamples - d;
+            int i1 = (newest - d) & this->mask; // circular logic
+            int i2 = (i1 - 1) & this->mask;
+            return this->pBuffer[i1] + frac * (this->pBuffer[i2] - this->pBuffer[i1]);
+        }
+
+    public:
+        //Constructor
+        Harmonizer() = delete;
+        /**
+         * @param sampleRate sample rate of your project
+         * @param numVoices number of pitch-shifted voices
+         * @param maxWindowMillis longest allowed window size (sets the buffer length)
+         */
+        Harmonizer(int sampleRate, int numVoices = 4, float maxWindowMillis = 300.f) : sampleRate(sampleRate) {
+            this->maxWindowSamples = giml::millisToSamples(maxWindowMillis, sampleRate);
+            this->allocate(numVoices, this->maxWindowSamples + 2);
+            for (int v = 0; v < numVoices; v++) {
+                this->pitchRatio[v] = 1.f;
+                this->windowSize[v] = 22.f;
+                this->gain[v] = 1.f;
+                this->updateVoice(v);
+            }
+        }
+        //Copy constructor
+        Harmonizer(const Harmonizer<T>& h) {
+            this->copyFrom(h);
+        }
+        //Copy assignment operator
+        Harmonizer<T>& operator=(const Harmonizer<T>& h) {
+            if (this != &h) {
+                this->copyFrom(h);
+            }
+            return *this;
+        }
+        //Destructor
+        ~Harmonizer() {
+            this->release();
+        }
+
+        int getNumVoices() const {
+            return this->numVoices;
+        }
+
+        /**
+         * @brief Set a voice's pitch change ratio
+         * @param voice index in `[0, numVoices)`
+         * @param ratio of desired pitch to input
+         */
+        void setPitchRatio(int voice, float ratio) {
+            if (!this->checkVoice(voice)) { return; }
+            this->pitchRatio[voice] = ratio;
+            this->updateVoice(voice);
+        }
+
+        /**
+         * @brief Set a voice's pitch change in semitones
+         * @param voice index in `[0, numVoices)`
+         * @param semitones desired interval
+         */
+        void setSemitones(int voice, float semitones) {
+            this->setPitchRatio(voice, ::powf(2.f, semitones / 12.f));
+        }
+
+        /**
+         * @brief Set a voice's window size (see `Detune::setWindowSize()`)
+         * @param voice index in `[0, numVoices)`
+         * @param sizeMillis the max amount of delay in milliseconds
+         */
+        void setWindowSize(int voice, float sizeMillis) {
+            if (!this->checkVoice(voice)) { return; }
+            float maxMillis = giml::samplesToMillis(this->maxWindowSamples, this->sampleRate);
+            this->windowSize[voice] = giml::clip<float>(sizeMillis, 1.f, maxMillis);
+            this->updateVoice(voice);
+        }
+
+        /**
+         * @brief Set a voice's output level
+         * @param voice index in `[0, numVoices)`
+         * @param g linear gain
+         */
+        void setGain(int voice, float g) {
+            if (!this->checkVoice(voice)) { return; }
+            this->gain[voice] = g;
+        }
+
+        /**
+         * @brief Process one sample through every voice
+         * @param in current sample
+         * @return sum of the voices
+         */
+        T processSample(T in) {
+            this->pBuffer[this->writeIndex] = in;
+            this->writeIndex = (this->writeIndex + 1) & this->mask; // circular logic
+
+            if (!(this->enabled)) {
+                return in;
+            }
+
+            //Pass 1 (all voices in lanes): advance the phasors, read positions and gain windows
+            for (int v = 0; v < this->numVoices; v++) {
+                T p = this->phase[v] + this->phaseIncrement[v];
+                p -= (p >= 1) ? 1 : 0;
+                p += (p < 0) ? 1 : 0;
+                this->phase[v] = p;
+                T p2 = p + T(0.5);
+                p2 -= (p2 >= 1) ? 1 : 0;
+                this->delay1[v] = p * this->windowSamples[v];
+                this->delay2[v] = p2 * this->windowSamples[v];
+                this->window1[v] = halfSine(p) * this->gain[v];
+                this->window2[v] = halfSine(p2) * this->gain[v];
+            }
+
+            //Pass 2: the buffer reads
+            int newest = (this->writeIndex - 1) & this->mask;
+            T out = 0;
+            for (int v = 0; v < this->numVoices; v++) {
+                out += this->read(newest, this->delay1[v]) * this->window1[v] + this->read(newest, this->delay2[v]) * this->window2[v];
+            }
+            return out;
+        }
+
+        /**
+         * @brief Process a block of samples
+         * @param in input samples
+         * @param out output samples (may be the same as `in`)
+         * @param numSamples number of samples
+         */
+        void processBlock(const T* in, T* out, int numSamples) {
+            for (int i = 0; i < numSamples; i++) {
+                out[i] = this->processSample(in[i]);
+            }
+        }
+    };
+}
+#endif
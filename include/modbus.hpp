@@ -0,0 +1,303 @@
+#ifndef GIML_MODBUS_HPP
+#define GIML_MODBUS_HPP
+#include "utility.hpp"
+#include "oscillator.hpp"
+namespace giml {
+    /**
+     * @brief A set of shared LFOs, each rendered once per block into a buffer that any number of effects can read
+     *
+     * Instead of every `Chorus`, `Phaser`, `Tremolo`, `Detune` and `Reverb` ticking its own oscillator every
+     * sample, call `render()` once at the start of each block and connect the effects to a source with their
+     * `setModSource()`. Effects connected to the same source are phase-locked for free.
+     *
+     * Each block has a generation number, so a `giml::ModTap` knows to start again from the first sample when a new
+     * block is rendered without the effects having to be told about block boundaries.
+     *
+     * Sources are stored structure-of-arrays and every block is computed from its starting phase
+     * (`phase + n * increment`, wrapped), so the rendering loops have no sample-to-sample dependency and vectorize.
+     *
+     * @tparam T floating-point type
+     */
+    template <typename T>
+    class ModBus {
+    public:
+        enum class Shape {
+            SINE, // `giml::SinOsc`
+            TRIANGLE, // `giml::TriOsc`
+            SAW // bipolar ramp, `giml::Phasor` scaled to [-1, 1]
+        };
+
+    private:
+        int sampleRate;
+        int maxBlockSize, maxSources;
+        int numSources = 0, blockSize = 0;
+        unsigned int generation = 0;
+        bool warnedBlockSize = false; // see `render()`
+
+        T* pPhases = nullptr; //maxSources blocks of maxBlockSize phases
+        T* pValues = nullptr; //maxSources blocks of maxBlockSize shaped outputs
+        T* pParams = nullptr; //per-source parameters and state (all in one allocation, see `allocate()`)
+        T *frequency, *phaseIncrement, *phase;
+        static const int numParams = 3;
+        Shape* pShapes = nullptr;
+
+        void allocate() {
+            this->release();
+            this->pPhases = (T*)::calloc(this->maxSources * this->maxBlockSize, sizeof(T));
+            this->pValues = (T*)::calloc(this->maxSources * this->maxBlockSize, sizeof(T));
+            this->pParams = (T*)::calloc(this->maxSources * numParams, sizeof(T));
+            this->frequency = this->pParams;
+            this->phaseIncrement = this->frequency + this->maxSources;
+            this->phase = this->phaseIncrement + this->maxSources;
+            this->pShapes = (Shape*)::calloc(this->maxSources, sizeof(Shape));
+        }
+
+        void release() {
+            ::free(this->pPhases);
+            ::free(this->pValues);
+            ::free(this->pParams);
+            ::free(this->pShapes);
+            this->pPhases = this->pValues = this->pParams = nullptr;
+            this->pShapes = nullptr;
+        }
+
+        void copyFrom(const ModBus<T>& m) {
+            this->sampleRate = m.sampleRate;
+            this->maxBlockSize = m.maxBlockSize;
+            this->maxSources = m.maxSources;
+            this->allocate();
+            this->numSources = m.numSources;
+            this->blockSize = m.blockSize;
+            this->generation = m.generation;
+            ::memcpy(this->pPhases, m.pPhases, this->maxSources * this->maxBlockSize * sizeof(T));
+            ::memcpy(this->pValues, m.pValues, this->maxSources * this->maxBlockSize * sizeof(T));
+            ::memcpy(this->pParams, m.pParams, this->maxSources * numParams * sizeof(T));
+            ::memcpy(this->pShapes, m.pShapes, this->maxSources * sizeof(Shape));
+        }
+
+        bool checkSource(int source) const {
+            if (source < 0 || source >= this->numSources) {
+                printf("ModBus source out of bounds\n");
+                return false;
+            }
+            return true;
+        }
+
+    public:
+        //Constructor
+        ModBus() = delete;
+        /**
+         * @param sampleRate sample rate of your project
+         * @param maxBlockSize largest block `render()` will be asked for
+         * @param maxSources largest number of LFOs
+         */
+        ModBus(int sampleRate, int maxBlockSize = 512, int maxSources = 16) :
+            sampleRate(sampleRate), maxBlockSize(maxBlockSize), maxSources(maxSources) {
+            this->allocate();
+        }
+        //Copy constructor
+        ModBus(const ModBus<T>& m) {
+            this->copyFrom(m);
+        }
+        //Copy assignment operator
+        ModBus<T>& operator=(const ModBus<T>& m) {
+            if (this != &m) {
+                this->copyFrom(m);
+            }
+            return *this;
+        }
+        //Destructor
+        ~ModBus() {
+            this->release();
+        }
+
+        /**
+         * @brief Adds an LFO to the bus
+         * @param shape waveform
+         * @param freqHz frequency in Hz (negative runs the phase backwards, like `giml::Phasor`)
+         * @param phaseOffset starting phase in `[0, 1)`
+         * @return the source's index to pass to `setModSource()`, or -1 if the bus is full
+         */
+        int addSource(Shape shape, float freqHz, float phaseOffset = 0.f) {
+            if (this->numSources >= this->maxSources) {
+                printf("ModBus is full\n");
+                return -1;
+            }
+            int source = this->numSources++;
+            this->pShapes[source] = shape;
+            this->phase[source] = phaseOffset - ::floor(phaseOffset);
+            this->setFrequency(source, freqHz);
+            return source;
+        }
+
+        /**
+         * @brief Sets a source's frequency, takes effect at the next `render()`
+         * @param source index returned by `addSource()`
+         * @param freqHz frequency in Hz
+         */
+        void setFrequency(int source, float freqHz) {
+            if (!this->checkSource(source)) { return; }
+            this->frequency[source] = freqHz;
+            this->phaseIncrement[source] = freqHz / static_cast<T>(this->sampleRate);
+        }
+
+        /**
+         * @brief Sets a source's waveform
+         * @param source index returned by `addSource()`
+         * @param shape waveform
+         */
+        void setShape(int source, Shape shape) {
+            if (!this->checkSource(source)) { return; }
+            this->pShapes[source] = shape;
+        }
+
+        /**
+         * @brief Sets a source's phase, e.g. to restart it on a new note
+         * @param source index returned by `addSource()`
+         * @param ph phase in `[0, 1)`
+         */
+        void setPhase(int source, float ph) {
+            if (!this->checkSource(source)) { return; }
+            this->phase[source] = ph - ::floor(ph);
+        }
+
+        /**
+         * @brief Advances every source by `numSamples` and starts a new generation. Call once per block,
+         * before processing the effects that read from the bus
+         * @param numSamples block size (clamped to `maxBlockSize`)
+         */
+        void render(int numSamples) {
+            if (numSamples > this->maxBlockSize) {
+                if (!this->warnedBlockSize) { // runs every block on the audio thread, so only report it once
+                    printf("ModBus block larger than maxBlockSize\n");
+                    this->warnedBlockSize = true;
+                }
+                numSamples = this->maxBlockSize;
+            }
+            for (int s = 0; s < this->numSources; s++) {
+                T* phases = this->pPhases + s * this->maxBlockSize;
+                T* values = this->pValues + s * this->maxBlockSize;
+                T start = this->phase[s], increment = this->phaseIncrement[s];
+                for (int n = 0; n < numSamples; n++) {
+                    T p = start + (n + 1) * increment; // phase after incrementing, like `Phasor::processSample()`
+                    phases[n] = p - ::floor(p);
+                }
+                switch (this->pShapes[s]) {
+                case Shape::SINE:
+                    for (int n = 0; n < numSamples; n++) {
+                        values[n] = giml::polySin(phases[n]);
+                    }
+                    break;
+                case Shape::TRIANGLE:
+                    for (int n = 0; n < numSamples; n++) {
+                        values[n] = ::abs(phases[n] * 2 - 1) * 2 - 1;
+                    }
+                    break;
+                case Shape::SAW:
+                    for (int n = 0; n < numSamples; n++) {
+                        values[n] = phases[n] * 2 - 1;
+                    }
+                    break;
+                }
+                T end = start + numSamples * increment;
+                this->phase[s] = end - ::floor(end);
+            }
+            this->blockSize = numSamples;
+            this->generation++;
+        }
+
+        int getNumSources() const {
+            return this->numSources;
+        }
+
+        int getBlockSize() const {
+            return this->blockSize;
+        }
+
+        /**
+         * @brief Incremented by every `render()`
+         */
+        unsigned int getGeneration() const {
+            return this->generation;
+        }
+
+        /**
+         * @param source index returned by `addSource()`
+         * @return the source's shaped output for the current block, `getBlockSize()` values
+         */
+        const T* getValues(int source) const {
+            return this->pValues + source * this->maxBlockSize;
+        }
+
+        /**
+         * @param source index returned by `addSource()`
+         * @return the source's phase in `[0, 1)` for the current block, `getBlockSize()` values
+         */
+        const T* getPhases(int source) const {
+            return this->pPhases + source * this->maxBlockSize;
+        }
+    };
+
+    /**
+     * @brief An effect's connection to one `giml::ModBus` source, read one sample at a time
+     *
+     * When the bus renders a new block (its generation changes) the tap starts again from the block's first sample.
+     * If an effect processes more samples than were rendered, the last value is held
+     *
+     * @tparam T floating-point type
+     */
+    template <typename T>
+    class ModTap {
+    private:
+        const ModBus<T>* bus = nullptr;
+        int source = 0, index = 0;
+        unsigned int generation = 0;
+        T phase = 0;
+
+    public:
+        /**
+         * @brief Connects to a source on a bus
+         * @param b bus to read from (`nullptr` disconnects)
+         * @param s index returned by `ModBus::addSource()`
+         */
+        void connect(const ModBus<T>* b, int s) {
+            if (b && (s < 0 || s >= b->getNumSources())) {
+                printf("ModBus source out of bounds\n");
+                b = nullptr;
+            }
+            this->bus = b;
+            this->source = s;
+            this->generation = b ? b->getGeneration() - 1 : 0; // start from the current block's first sample
+            this->index = 0;
+        }
+
+        bool isConnected() const {
+            return this->bus != nullptr;
+        }
+
+        /**
+         * @brief Reads the next sample of the source
+         * @return the source's shaped output
+         */
+        T next() {
+            if (this->bus->getGeneration() != this->generation) {
+                this->generation = this->bus->getGeneration();
+                this->index = 0;
+            }
+            int last = this->bus->getBlockSize() - 1;
+            if (last < 0) { return 0; } // nothing rendered yet
+            int i = (this->index < last) ? this->index++ : last;
+            this->phase = this->bus->getPhases(this->source)[i];
+            return this->bus->getValues(this->source)[i];
+        }
+
+        /**
+         * @brief Phase of the sample last returned by `next()`
+         * @return phase in `[0, 1)`
+         */
+        T getPhase() const {
+            return this->phase;
+        }
+    };
+}
+#endif
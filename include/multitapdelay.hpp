@@ -0,0 +1,366 @@
+#ifndef GIML_MULTITAPDELAY_HPP
+#define GIML_MULTITAPDELAY_HPP
+#include "utility.hpp"
+#include "filter.hpp"
+namespace giml {
+    /**
+     * @brief This class implements a stereo multi-tap delay with tempo sync and ping-pong feedback.
+     *
+     * Up to 8 taps read one interleaved stereo buffer (left and right of a frame are neighbours, so a tap's
+     * read touches one cache line). Each tap has its own time, gain, pan and damping (a one-pole lowpass),
+     * stored structure-of-arrays so the per-tap math runs as one loop over the taps after the reads.
+     *
+     * The longest tap feeds back into the buffer. In ping-pong mode its left output feeds the right channel
+     * and vice versa, and mono input goes into the left channel only, so echoes bounce between the speakers.
+     *
+     * @tparam T floating-point type for input and output sample data such as `float`, `double`, or `long double`
+     */
+    template <typename T>
+    class MultiTapDelay : public Effect<T> {
+    private:
+        static const int maxTaps = 8;
+
+        int sampleRate;
+        float bpm = 120.f;
+        T feedback = 0, blend = 0.5;
+        bool pingPong = false;
+
+        T* pBuffer = nullptr; //frames of [left, right], a power of 2 frames long
+        size_t numFrames = 0, writeIndex = 0;
+        size_t mask = 0;
+
+        int numTaps = 1;
+        int feedbackTap = 0; //index of the longest tap
+        T tapMillis[maxTaps], tapDelay[maxTaps], tapGain[maxTaps], tapPanLeft[maxTaps], tapPanRight[maxTaps],
+            tapDamping[maxTaps], tapStateLeft[maxTaps], tapStateRight[maxTaps];
+        NoteDivision tapDivision[maxTaps];
+        bool tapSynced[maxTaps];
+        T tapLeft[maxTaps], tapRight[maxTaps]; //scratch for the current sample
+
+        giml::onePole<T> dcBlockLeft, dcBlockRight; // See Generating Sound & Organizing Time I - Wakefield and Taylor 2022 Chapter 7 pg. 204
+
+        void allocate(size_t frames) {
+            ::free(this->pBuffer);
+            this->numFrames = 1;
+            while (this->numFrames < frames) {
+                this->numFrames *= 2;
+            }
+            this->mask = this->numFrames - 1;
+            this->writeIndex = 0;
+            this->pBuffer = (T*)::calloc(2 * this->numFrames, sizeof(T));
+        }
+
+        bool checkTap(int tap) const {
+            if (tap < 0 || tap >= maxTaps) {
+                printf("MultiTapDelay tap out of bounds\n");
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Converts a tap's time to samples and finds the longest active tap
+         */
+        void updateTap(int tap) {
+            if (this->tapSynced[tap]) {
+                this->tapMillis[tap] = giml::noteDivisionToMillis(this->tapDivision[tap], this->bpm);
+            }
+            float maxMillis = giml::samplesToMillis(this->numFrames - 2, this->sampleRate);
+            this->tapMillis[tap] = giml::clip<T>(this->tapMillis[tap], 0, maxMillis);
+            this->tapDelay[tap] = giml::clip<T>(giml::millisToSamples(this->tapMillis[tap], this->sampleRate), 1, this->numFrames - 2);
+            this->feedbackTap = 0;
+            for (int i = 1; i < this->numTaps; i++) {
+                if (this->tapDelay[i] > this->tapDelay[this->feedbackTap]) {
+                    this->feedbackTap = i;
+                }
+            }
+        }
+
+        /**
+         * @brief Reads and filters every tap into `tapLeft`/`tapRight`, then writes the new frame
+         */
+        void processFrame(T inLeft, T inRight) {
+            //Pass 1: interpolated reads of both channels of every tap
+            for (int i = 0; i < this->numTaps; i++) {
+                int d = (int)this->tapDelay[i];
+                T frac = this->tapDelay[i] - d;
+                size_t i1 = (this->writeIndex - d) & this->mask; // circular logic
+                size_t i2 = (i1 - 1) & this->mask;
+                const T* frame1 = this->pBuffer + 2 * i1;
+                const T* frame2 = this->pBuffer + 2 * i2;
+                this->tapLeft[i] = frame1[0] + frac * (frame2[0] - frame1[0]);
+                this->tapRight[i] = frame1[1] + frac * (frame2[1] - frame1[1]);
+            }
+
+            //Pass 2: damping for all taps at once (same one-pole as `giml::onePole::lpf()`)
+            for (int i = 0; i < this->numTaps; i++) {
+                T a = this->tapDamping[i];
+                this->tapStateLeft[i] = this->tapLeft[i] * (1 - a) + this->tapStateLeft[i] * a;
+                this->tapStateRight[i] = this->tapRight[i] * (1 - a) + this->tapStateRight[i] * a;
+            }
+
+            //Feedback from the longest tap, crossed over in ping-pong mode
+            T fbLeft = this->tapStateLeft[this->feedbackTap] * this->feedback;
+            T fbRight = this->tapStateRight[this->feedbackTap] * this->feedback;
+            if (this->pingPong) {
+                T temp = fbLeft;
+                fbLeft = fbRight;
+                fbRight = temp;
+            }
+            T* frame = this->pBuffer + 2 * this->writeIndex;
+            frame[0] = this->dcBlockLeft.hpf(inLeft + fbLeft);
+            frame[1] = this->dcBlockRight.hpf(inRight + fbRight);
+            this->writeIndex = (this->writeIndex + 1) & this->mask; // circular logic
+        }
+
+        /**
+         * @brief Gain and pan for all taps at once
+         */
+        void mixTaps(T& wetLeft, T& wetRight) const {
+            wetLeft = wetRight = 0;
+            for (int i = 0; i < this->numTaps; i++) {
+                wetLeft += this->tapStateLeft[i] * this->tapGain[i] * this->tapPanLeft[i];
+                wetRight += this->tapStateRight[i] * this->tapGain[i] * this->tapPanRight[i];
+            }
+        }
+
+    public:
+        //Constructor
+        MultiTapDelay() = delete;
+        /**
+         * @param sampleRate sample rate of your project
+         * @param maxDelayMillis longest allowed tap time
+         */
+        MultiTapDelay(int sampleRate, float maxDelayMillis = 3000.f) : sampleRate(sampleRate) {
+            this->allocate(giml::millisToSamples(maxDelayMillis, sampleRate) + 2);
+            this->dcBlockLeft.setCutoff(3, sampleRate);// set dcBlock at 3Hz
+            this->dcBlockRight.setCutoff(3, sampleRate);
+            for (int i = 0; i < maxTaps; i++) {
+                this->tapMillis[i] = 250.f * (i + 1);
+                this->tapGain[i] = 1;
+                this->tapPanLeft[i] = this->tapPanRight[i] = 1;
+                this->tapDamping[i] = this->tapStateLeft[i] = this->tapStateRight[i] = 0;
+                this->tapDivision[i] = NoteDivision::QUARTER;
+                this->tapSynced[i] = false;
+            }
+            for (int i = 0; i < maxTaps; i++) {
+                this->updateTap(i);
+            }
+        }
+        //Copy constructor
+        MultiTapDelay(const MultiTapDelay<T>& d) {
+            *this = d; //pBuffer starts as nullptr, so assignment can free it
+        }
+        //Copy assignment operator
+        MultiTapDelay<T>& operator=(const MultiTapDelay<T>& d) {
+            if (this != &d) {
+                this->enabled = d.enabled;
+                this->sampleRate = d.sampleRate;
+                this->bpm = d.bpm;
+                this->feedback = d.feedback;
+                this->blend = d.blend;
+                this->pingPong = d.pingPong;
+                this->numTaps = d.numTaps;
+                this->feedbackTap = d.feedbackTap;
+                this->dcBlockLeft = d.dcBlockLeft;
+                this->dcBlockRight = d.dcBlockRight;
+                for (int i = 0; i < maxTaps; i++) {
+                    this->tapMillis[i] = d.tapMillis[i];
+                    this->tapDelay[i] = d.tapDelay[i];
+                    this->tapGain[i] = d.tapGain[i];
+                    this->tapPanLeft[i] = d.tapPanLeft[i];
+                    this->tapPanRight[i] = d.tapPanRight[i];
+                    this->tapDamping[i] = d.tapDamping[i];
+                    this->tapStateLeft[i] = d.tapStateLeft[i];
+                    this->tapStateRight[i] = d.tapStateRight[i];
+                    this->tapDivision[i] = d.tapDivision[i];
+                    this->tapSynced[i] = d.tapSynced[i];
+                }
+                this->allocate(d.numFrames);
+                this->writeIndex = d.writeIndex;
+                ::memcpy(this->pBuffer, d.pBuffer, 2 * d.numFrames * sizeof(T));
+            }
+            return *this;
+        }
+        //Destructor
+        ~MultiTapDelay() {
+            ::free(this->pBuffer);
+        }
+
+        /**
+         * @return how long the echoes of the longest tap take to decay by 60dB, in seconds (same as
+         * `Delay::getTailLength()`, feedback is capped below 1 so it is always finite)
+         */
+        float getTailLength() override {
+            T longest = this->tapDelay[this->feedbackTap];
+            T tailSamples = longest;
+            if (this->feedback > 0) {
+                tailSamples = longest * (1 - 3 / ::log10(this->feedback)); // -60dB after 3 / -log10(feedback) repeats
+            }
+            return tailSamples / this->sampleRate;
+        }
+
+        /**
+         * @brief Process one stereo frame
+         * @param inLeft left input sample
+         * @param inRight right input sample
+         * @param outLeft left output sample
+         * @param outRight right output sample
+         */
+        void processSample(T inLeft, T inRight, T& outLeft, T& outRight) {
+            if (!(this->enabled)) {
+                outLeft = inLeft;
+                outRight = inRight;
+                return;
+            }
+            this->processFrame(inLeft, inRight);
+            T wetLeft, wetRight;
+            this->mixTaps(wetLeft, wetRight);
+            outLeft = giml::linMix<T>(inLeft, wetLeft, this->blend); // return wet/dry mix
+            outRight = giml::linMix<T>(inRight, wetRight, this->blend);
+        }
+
+        /**
+         * @brief Process one mono sample (in ping-pong mode it enters the left channel only)
+         * @param in input sample
+         * @return average of the left and right outputs
+         */
+        T processSample(T in) {
+            if (!(this->enabled)) {return in;}
+            this->processFrame(in, (this->pingPong) ? 0 : in);
+            T wetLeft, wetRight;
+            this->mixTaps(wetLeft, wetRight);
+            return giml::linMix<T>(in, (wetLeft + wetRight) / 2, this->blend); // return wet/dry mix
+        }
+
+        /**
+         * @brief Process a block of mono samples
+         * @param in input samples
+         * @param out output samples (may be the same as `in`)
+         * @param numSamples number of samples
+         */
+        void processBlock(const T* in, T* out, int numSamples) {
+            for (int i = 0; i < numSamples; i++) {
+                out[i] = this->processSample(in[i]);
+            }
+        }
+
+        /**
+         * @brief Process a block of stereo samples
+         * @param inLeft left input samples
+         * @param inRight right input samples
+         * @param outLeft left output samples (may be the same as `inLeft`)
+         * @param outRight right output samples (may be the same as `inRight`)
+         * @param numSamples number of samples
+         */
+        void processBlock(const T* inLeft, const T* inRight, T* outLeft, T* outRight, int numSamples) {
+            for (int i = 0; i < numSamples; i++) {
+                this->processSample(inLeft[i], inRight[i], outLeft[i], outRight[i]);
+            }
+        }
+
+        /**
+         * @brief Set the number of active taps
+         * @param taps clamped to [1, 8]
+         */
+        void setNumTaps(int taps) {
+            this->numTaps = giml::clip<int>(taps, 1, maxTaps);
+            for (int i = 0; i < maxTaps; i++) {
+                this->tapStateLeft[i] = this->tapStateRight[i] = 0;
+            }
+            this->updateTap(0);
+        }
+
+        /**
+         * @brief Set a tap's time in milliseconds (turns off tempo sync for that tap)
+         * @param tap index in `[0, 8)`
+         * @param millis delay time, clamped to the buffer length
+         */
+        void setTapTime(int tap, float millis) {
+            if (!this->checkTap(tap)) { return; }
+            this->tapSynced[tap] = false;
+            this->tapMillis[tap] = millis;
+            this->updateTap(tap);
+        }
+
+        /**
+         * @brief Sync a tap's time to the tempo (see `setTempo()`)
+         * @param tap index in `[0, 8)`
+         * @param division note length of the tap's delay
+         */
+        void setTapDivision(int tap, NoteDivision division) {
+            if (!this->checkTap(tap)) { return; }
+            this->tapSynced[tap] = true;
+            this->tapDivision[tap] = division;
+            this->updateTap(tap);
+        }
+
+        /**
+         * @brief Set the tempo that synced taps follow
+         * @param beatsPerMinute tempo in quarter notes per minute
+         */
+        void setTempo(float beatsPerMinute) {
+            this->bpm = (beatsPerMinute > 0) ? beatsPerMinute : 120.f;
+            for (int i = 0; i < maxTaps; i++) {
+                this->updateTap(i);
+            }
+        }
+
+        /**
+         * @brief Set a tap's output level
+         * @param tap index in `[0, 8)`
+         * @param g linear gain
+         */
+        void setTapGain(int tap, float g) {
+            if (!this->checkTap(tap)) { return; }
+            this->tapGain[tap] = g;
+        }
+
+        /**
+         * @brief Set a tap's balance between the left and right outputs (equal-power, gain 1 per channel at center)
+         * @param tap index in `[0, 8)`
+         * @param pan -1 for hard left, 1 for hard right
+         */
+        void setTapPan(int tap, float pan) {
+            if (!this->checkTap(tap)) { return; }
+            float angle = (giml::clip<float>(pan, -1.f, 1.f) + 1.f) * M_PI / 4.f;
+            this->tapPanLeft[tap] = ::cosf(angle) * M_SQRT2;
+            this->tapPanRight[tap] = ::sinf(angle) * M_SQRT2;
+        }
+
+        /**
+         * @brief Set a tap's damping (one-pole lowpass on its output, also applied to the feedback of the longest tap)
+         * @param tap index in `[0, 8)`
+         * @param a damping value. Clipped to `[0,1)`
+         */
+        void setTapDamping(int tap, float a) {
+            if (!this->checkTap(tap)) { return; }
+            this->tapDamping[tap] = giml::clip<float>(a, 0.f, 0.999f);
+        }
+
+        /**
+         * @brief Set the feedback gain of the longest tap
+         * @param fbGain clipped to `[0, 0.99]` so the loop always decays
+         */
+        void setFeedback(float fbGain) {
+            this->feedback = giml::clip<float>(fbGain, 0.f, 0.99f);
+        }
+
+        /**
+         * @brief Turn ping-pong feedback on or off
+         * @param on whether the feedback crosses between channels
+         */
+        void setPingPong(bool on) {
+            this->pingPong = on;
+        }
+
+        /**
+         * @brief Set blend (linear)
+         * @param gWet percentage of wet to blend in. Clipped to `[0,1]`
+         */
+        void setBlend(float gWet) {
+            this->blend = giml::clip<float>(gWet, 0.f, 1.f);
+        }
+    };
+}
+#endif
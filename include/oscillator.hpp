@@ -2,6 +2,21 @@
 #define GIML_OSCILLATOR_HPP
 #include "utility.hpp"
 namespace giml {
+    /**
+     * @brief `sin(2pi * phase)` as an odd polynomial (max error ~1e-7). Branch-free, so loops over many phases vectorize
+     * @param phase in `[0, 1)`
+     * @return sine of `phase` cycles
+     */
+    template <typename T>
+    inline T polySin(T phase) {
+        T x = T(0.5) - phase; // sin(2pi * phase) = sin(2pi * (0.5 - phase)), x in (-0.5, 0.5]
+        x = std::copysign(T(0.25) - ::abs(::abs(x) - T(0.25)), x); // fold to [-0.25, 0.25] using sin(pi - a) = sin(a)
+        T a = x * T(M_2PI);
+        T a2 = a * a;
+        return a * (T(1) + a2 * (T(-1.0 / 6) + a2 * (T(1.0 / 120) + a2 * (T(-1.0 / 5040)
+            + a2 * (T(1.0 / 362880) + a2 * T(-1.0 / 39916800))))));
+    }
+
     /**
      * @brief Phase Accumulator / Unipolar Saw Oscillator.
      * Can be used as a control signal and/or waveshaped into other waveforms. 
@@ -63,6 +78,15 @@ namespace giml {
             } else {return this->phase;} // return phasor
         }
 
+        /**
+         * @brief Advances `phase` as if `processSample()` had been called `numSamples` times
+         * @param numSamples number of samples to skip
+         */
+        void skip(int numSamples) {
+            this->phase += numSamples * this->phaseIncrement;
+            this->phase -= ::floor(this->phase);
+        }
+
         /**
          * @brief Sets `phase` manually 
          * @param ph User-defined phase. 
@@ -119,5 +143,100 @@ namespace giml {
             return ::abs(Phasor<T>::processSample() * 2 - 1) * 2 - 1;
         }
     };
+
+    /**
+     * @brief Quadrature Sine/Cosine Oscillator that inherits from `giml::Phasor`
+     *
+     * Instead of calling `std::sin` every sample, the point `(cos, sin)` is rotated around the unit circle by
+     * the phase increment (a coupled-form recursion: 4 multiplies and 2 adds per sample, sine and cosine for free).
+     * Rounding errors slowly pull the point off the circle, so every `resyncInterval` samples it is
+     * recalculated exactly from the phasor's phase, which keeps amplitude and phase locked to `SinOsc`.
+     * Best used as an LFO or wherever both sine and cosine are needed
+     */
+    template <typename T>
+    class QuadOsc : public Phasor<T> {
+    private:
+        static const int resyncInterval = 128;
+        T sinValue = 0, cosValue = 1; // point on the unit circle for `phase`
+        T sinIncrement = 0, cosIncrement = 1; // rotation by `phaseIncrement`
+        int samplesUntilResync = 0;
+
+        void resync() {
+            this->sinValue = ::sin(M_2PI * this->phase);
+            this->cosValue = ::cos(M_2PI * this->phase);
+            this->samplesUntilResync = resyncInterval;
+        }
+
+        void updateIncrement() {
+            this->sinIncrement = ::sin(M_2PI * this->phaseIncrement);
+            this->cosIncrement = ::cos(M_2PI * this->phaseIncrement);
+        }
+
+    public:
+        QuadOsc(int sampRate) : Phasor<T>(sampRate) {}
+
+        void setSampleRate(int sampRate) override {
+            Phasor<T>::setSampleRate(sampRate);
+            this->updateIncrement();
+            this->resync();
+        }
+
+        void setFrequency(T freqHz) override {
+            Phasor<T>::setFrequency(freqHz);
+            this->updateIncrement();
+            this->resync();
+        }
+
+        void setPhase(T ph) override {
+            Phasor<T>::setPhase(ph);
+            this->resync();
+        }
+
+        /**
+         * @brief Increments `phase` and rotates the sine/cosine pair
+         * @return `sin(2pi * phase)` (after increment)
+         */
+        T processSample() override {
+            Phasor<T>::processSample();
+            if (--this->samplesUntilResync <= 0) {
+                this->resync();
+            } else {
+                T c = this->cosValue * this->cosIncrement - this->sinValue * this->sinIncrement;
+                this->sinValue = this->sinValue * this->cosIncrement + this->cosValue * this->sinIncrement;
+                this->cosValue = c;
+            }
+            return this->getSin();
+        }
+
+        /**
+         * @brief Returns the sine of the current phase without incrementing
+         * @return `sin(2pi * phase)`
+         */
+        T getSin() const {
+            return (this->frequency < 0) ? -this->sinValue : this->sinValue; // reverse phasor mirrors the sine
+        }
+
+        /**
+         * @brief Returns the cosine of the current phase without incrementing
+         * @return `cos(2pi * phase)`
+         */
+        T getCos() const {
+            return this->cosValue;
+        }
+
+        /**
+         * @brief Fills blocks with consecutive sine and cosine samples
+         * @param sinOut sine output (may be `nullptr`)
+         * @param cosOut cosine output (may be `nullptr`)
+         * @param numSamples number of samples
+         */
+        void process(T* sinOut, T* cosOut, int numSamples) {
+            for (int n = 0; n < numSamples; n++) {
+                T s = this->QuadOsc<T>::processSample();
+                if (sinOut) { sinOut[n] = s; }
+                if (cosOut) { cosOut[n] = this->cosValue; }
+            }
+        }
+    };
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,204 @@
+#ifndef GIML_OSCILLATORBANK_HPP
+#define GIML_OSCILLATORBANK_HPP
+#include "utility.hpp"
+#include "oscillator.hpp"
+namespace giml {
+    /**
+     * @brief A bank of sine partials for additive synthesis, organ patches and test signals
+     *
+     * Partials are stored structure-of-arrays (phase, increment, amplitude and their targets) and rendered
+     * one partial at a time across the whole block. Every sample's phase is calculated directly from the phase
+     * at the start of its 256-sample segment instead of accumulated, and the sine is `giml::polySin()`, so the inner loop has no
+     * sample-to-sample dependency and vectorizes.
+     *
+     * `setFrequency()` and `setAmplitude()` set targets: the next `process()` call ramps linearly from the
+     * current values to the targets over its block, so changes don't click. Partials at or above Nyquist are muted.
+     *
+     * @tparam T floating-point type
+     */
+    template <typename T>
+    class OscillatorBank {
+    private:
+        int sampleRate;
+        int maxPartials, numPartials;
+
+        //Per-partial parameters and state (all in one allocation, see `allocate()`)
+        T* pParams = nullptr;
+        T *phase, *increment, *amplitude, //current values
+            *targetIncrement, *targetAmplitude; //reached at the end of the next block
+        static const int numParams = 5;
+        static const int anchorSize = 256; // `process()` recalculates the starting phase this often, so `k * inc` stays precise in float
+
+        void allocate() {
+            ::free(this->pParams);
+            this->pParams = (T*)::calloc(this->maxPartials * numParams, sizeof(T));
+            this->phase = this->pParams;
+            this->increment = this->phase + this->maxPartials;
+            this->amplitude = this->increment + this->maxPartials;
+            this->targetIncrement = this->amplitude + this->maxPartials;
+            this->targetAmplitude = this->targetIncrement + this->maxPartials;
+        }
+
+        void copyFrom(const OscillatorBank<T>& b) {
+            this->sampleRate = b.sampleRate;
+            this->maxPartials = b.maxPartials;
+            this->numPartials = b.numPartials;
+            this->allocate();
+            ::memcpy(this->pParams, b.pParams, this->maxPartials * numParams * sizeof(T));
+        }
+
+        bool checkPartial(int partial) const {
+            if (partial < 0 || partial >= this->maxPartials) {
+                printf("OscillatorBank partial out of bounds\n");
+                return false;
+            }
+            return true;
+        }
+
+    public:
+        //Constructor
+        OscillatorBank() = delete;
+        /**
+         * @param sampleRate sample rate of your project
+         * @param maxPartials largest number of partials
+         */
+        OscillatorBank(int sampleRate, int maxPartials = 256) :
+            sampleRate(sampleRate), maxPartials(maxPartials), numPartials(maxPartials) {
+            this->allocate();
+        }
+        //Copy constructor
+        OscillatorBank(const OscillatorBank<T>& b) {
+            this->copyFrom(b);
+        }
+        //Copy assignment operator
+        OscillatorBank<T>& operator=(const OscillatorBank<T>& b) {
+            if (this != &b) {
+                this->copyFrom(b);
+            }
+            return *this;
+        }
+        //Destructor
+        ~OscillatorBank() {
+            ::free(this->pParams);
+        }
+
+        /**
+         * @brief Sets how many partials are rendered (partials past this keep their settings but are skipped)
+         * @param n number of partials (clamped to `[0, maxPartials]`)
+         */
+        void setNumPartials(int n) {
+            this->numPartials = giml::clip<int>(n, 0, this->maxPartials);
+        }
+
+        int getNumPartials() const {
+            return this->numPartials;
+        }
+
+        /**
+         * @brief Sets a partial's frequency, reached by the end of the next block
+         * @param partial index in `[0, maxPartials)`
+         * @param freqHz frequency in Hz
+         */
+        void setFrequency(int partial, T freqHz) {
+            if (!this->checkPartial(partial)) { return; }
+            this->targetIncrement[partial] = ::abs(freqHz) / static_cast<T>(this->sampleRate);
+        }
+
+        /**
+         * @brief Sets a partial's amplitude, reached by the end of the next block
+         * @param partial index in `[0, maxPartials)`
+         * @param amp linear amplitude
+         */
+        void setAmplitude(int partial, T amp) {
+            if (!this->checkPartial(partial)) { return; }
+            this->targetAmplitude[partial] = amp;
+        }
+
+        /**
+         * @brief Jumps a partial to its target frequency and amplitude without ramping, e.g. before the first block
+         * @param partial index in `[0, maxPartials)`
+         */
+        void snapToTarget(int partial) {
+            if (!this->checkPartial(partial)) { return; }
+            this->increment[partial] = this->targetIncrement[partial];
+            this->amplitude[partial] = this->targetAmplitude[partial];
+        }
+
+        /**
+         * @brief Sets a partial's phase
+         * @param partial index in `[0, maxPartials)`
+         * @param ph phase in `[0, 1)`
+         */
+        void setPhase(int partial, T ph) {
+            if (!this->checkPartial(partial)) { return; }
+            this->phase[partial] = ph - ::floor(ph);
+        }
+
+        /**
+         * @brief Sets partials `0` to `numHarmonics - 1` to the harmonics of a fundamental (muting the rest)
+         * @param fundamentalHz frequency of the first harmonic in Hz
+         * @param amplitudes amplitude of each harmonic
+         * @param numHarmonics number of harmonics (clamped to `maxPartials`)
+         */
+        void setHarmonics(T fundamentalHz, const T* amplitudes, int numHarmonics) {
+            this->setNumPartials(numHarmonics);
+            for (int p = 0; p < this->numPartials; p++) {
+                this->setFrequency(p, fundamentalHz * (p + 1));
+                this->setAmplitude(p, amplitudes[p]);
+            }
+        }
+
+        /**
+         * @brief Resets every phase to 0 and jumps every partial to its targets
+         */
+        void reset() {
+            for (int p = 0; p < this->maxPartials; p++) {
+                this->phase[p] = 0;
+                this->snapToTarget(p);
+            }
+        }
+
+        /**
+         * @brief Renders the sum of all partials for one block, ramping frequencies and amplitudes to their targets
+         * @param out output samples (overwritten)
+         * @param numSamples number of samples
+         */
+        void process(T* out, int numSamples) {
+            ::memset(out, 0, numSamples * sizeof(T));
+            if (numSamples <= 0) { return; }
+            T invN = T(1) / numSamples;
+            for (int p = 0; p < this->numPartials; p++) {
+                T inc = this->increment[p];
+                T dInc = (this->targetIncrement[p] - inc) * invN;
+                T amp = (inc < T(0.5)) ? this->amplitude[p] : 0; // mute partials above Nyquist
+                T endAmp = (this->targetIncrement[p] < T(0.5)) ? this->targetAmplitude[p] : 0;
+                T dAmp = (endAmp - amp) * invN;
+                bool audible = (amp != 0 || endAmp != 0);
+                double anchor = this->phase[p]; // phase at the start of each segment, kept in double between segments
+
+                for (int s0 = 0; s0 < numSamples; s0 += anchorSize) {
+                    int len = (numSamples - s0 < anchorSize) ? numSamples - s0 : anchorSize;
+                    T start = T(anchor);
+                    T segInc = inc + dInc * s0; // increment reached at the start of this segment
+                    T segAmp = amp + dAmp * s0;
+                    if (audible) {
+                        for (int n = 0; n < len; n++) {
+                            //k increments so far, the increment grows by dInc each sample: sum = k*segInc + dInc*k(k+1)/2
+                            T k = T(n + 1);
+                            T ph = start + k * segInc + dInc * (k * (k + 1) * T(0.5));
+                            ph -= (int)ph; // wrap to [0, 1), phases are never negative
+                            out[s0 + n] += (segAmp + k * dAmp) * giml::polySin(ph);
+                        }
+                    }
+                    double k = len;
+                    double end = anchor + k * (double)segInc + (double)dInc * (k * (k + 1) * 0.5);
+                    anchor = end - ::floor(end);
+                }
+                this->phase[p] = T(anchor);
+                this->increment[p] = this->targetIncrement[p];
+                this->amplitude[p] = this->targetAmplitude[p];
+            }
+        }
+    };
+}
+#endif
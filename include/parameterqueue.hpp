@@ -0,0 +1,107 @@
+#ifndef GIML_PARAMETERQUEUE_HPP
+#define GIML_PARAMETERQUEUE_HPP
+#include <atomic>
+#include "utility.hpp"
+namespace giml {
+    /**
+     * @brief Wait-free single-producer/single-consumer queue of parameter changes for one effect
+     *
+     * Effect setters write plain members that the audio thread reads, so calling them from a UI or network
+     * thread is a data race. Instead, the control thread `push()`es a message naming the setter and its value,
+     * and the audio thread calls `applyAll()` at the start of each block, so every setter runs on the audio thread
+     * between blocks. Neither side ever locks or allocates: messages live in a fixed ring buffer and the two threads
+     * only share the read and write indices, which are atomics padded onto separate cache lines.
+     *
+     * ```
+     * giml::ParameterQueue<giml::Tremolo<float>> queue;
+     * queue.push(&giml::Tremolo<float>::setDepth, 0.5f); // control thread
+     * queue.applyAll(tremolo); // audio thread, before processBlock()
+     * ```
+     *
+     * Setters that allocate or do heavy math still do it on the audio thread when applied this way, so they don't
+     * belong in the queue: `Reverb` has `prepareParams()` for changing its parameters from another thread.
+     *
+     * @tparam E effect type
+     * @tparam V setter argument type
+     */
+    template <typename E, typename V = float>
+    class ParameterQueue {
+    public:
+        using Setter = void (E::*)(V);
+
+    private:
+        struct Message {
+            Setter setter;
+            V value;
+        };
+
+        Message* pMessages = nullptr;
+        size_t capacity = 0, mask = 0; // capacity is a power of 2 so indices wrap with a mask
+        // The indices are padded 64 bytes apart (a cache line) instead of `alignas(64)`, which C++14 `new` ignores
+        char pad0[64];
+        std::atomic<size_t> writeIndex{0}; // only written by the control thread
+        char pad1[64 - sizeof(std::atomic<size_t>)];
+        std::atomic<size_t> readIndex{0}; // only written by the audio thread
+        char pad2[64 - sizeof(std::atomic<size_t>)];
+
+    public:
+        /**
+         * @param capacity most messages that can wait between two `applyAll()` calls (rounded up to a power of 2)
+         */
+        ParameterQueue(size_t capacity = 256) {
+            this->capacity = 1;
+            while (this->capacity < capacity) {
+                this->capacity *= 2;
+            }
+            this->mask = this->capacity - 1;
+            this->pMessages = (Message*)::calloc(this->capacity, sizeof(Message));
+        }
+        ~ParameterQueue() {
+            ::free(this->pMessages);
+        }
+        // The indices are shared between two threads, so a queue can't be copied
+        ParameterQueue(const ParameterQueue&) = delete;
+        ParameterQueue& operator=(const ParameterQueue&) = delete;
+
+        /**
+         * @brief Queues a setter call (control thread only)
+         * @param setter pointer to the effect's setter, e.g. `&giml::Delay<float>::setBlend`
+         * @param value argument for the setter
+         * @return false if the queue is full (the change is dropped)
+         */
+        bool push(Setter setter, V value) {
+            size_t w = this->writeIndex.load(std::memory_order_relaxed);
+            if (w - this->readIndex.load(std::memory_order_acquire) >= this->capacity) {
+                return false;
+            }
+            this->pMessages[w & this->mask] = Message{ setter, value };
+            this->writeIndex.store(w + 1, std::memory_order_release); // publishes the message
+            return true;
+        }
+
+        /**
+         * @brief Runs every queued setter on `effect` in the order they were pushed (audio thread only)
+         * @param effect effect to update
+         * @return number of messages applied
+         */
+        int applyAll(E& effect) {
+            size_t r = this->readIndex.load(std::memory_order_relaxed);
+            size_t w = this->writeIndex.load(std::memory_order_acquire);
+            int count = 0;
+            for (; r != w; r++, count++) {
+                const Message& m = this->pMessages[r & this->mask];
+                (effect.*(m.setter))(m.value);
+            }
+            this->readIndex.store(r, std::memory_order_release); // frees the slots for the control thread
+            return count;
+        }
+
+        /**
+         * @brief Number of messages waiting (approximate while the other thread is running)
+         */
+        size_t size() const {
+            return this->writeIndex.load(std::memory_order_acquire) - this->readIndex.load(std::memory_order_acquire);
+        }
+    };
+}
+#endif
@@ -3,6 +3,7 @@
 #include <math.h>
 #include "utility.hpp"
 #include "oscillator.hpp"
+#include "modbus.hpp"
 #include "biquad.hpp"
 namespace giml {
     /**
@@ -16,6 +17,7 @@ namespace giml {
         int sampleRate;
         float rate = 1.f;
         giml::TriOsc<T> osc;
+        giml::ModTap<T> modTap; // replaces `osc` when connected, see `setModSource()`
 
         static const int N = 6;
         giml::Biquad<T> filterbank[N];
@@ -37,7 +39,7 @@ namespace giml {
          */
         T processSample(T in) {
             float wet = in;
-            float mod = osc.processSample();
+            float mod = this->modTap.isConnected() ? this->modTap.next() : osc.processSample();
 
             for (int i = 0; i < this->N; i++) {
                 //this->filterbank[i].setParams(Fc(i) + mod * depth(i))
@@ -60,6 +62,15 @@ namespace giml {
         void setRate(float freq) {
             this->osc.setFrequency(freq); // set frequency in Hz
         }
+
+        /**
+         * @brief Use a shared LFO from a `giml::ModBus` instead of `osc`
+         * @param bus bus to read from (`nullptr` goes back to `osc`)
+         * @param source index returned by `ModBus::addSource()`
+         */
+        void setModSource(const giml::ModBus<T>* bus, int source = 0) {
+            this->modTap.connect(bus, source);
+        }
     };
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,235 @@
+#ifndef GIML_PITCHSHIFTER_HPP
+#define GIML_PITCHSHIFTER_HPP
+#include "utility.hpp"
+#include "stft.hpp"
+namespace giml {
+    /**
+     * @brief This class implements a frequency-domain (phase vocoder) pitchshifter
+     *
+     * Unlike `giml::Detune`, which crossfades two read heads of a delay line, each STFT frame is split into
+     * regions around its spectral peaks and every region is moved to its new frequency as a whole
+     * (Laroche & Dolson's identity phase locking): the peak gets a phase that continues smoothly from the last
+     * frame and the bins around it keep their phase relative to the peak. Each partial of a chord is moved on
+     * its own, so chords don't warble, and large shifts sound less "phasey" than with a plain phase vocoder.
+     *
+     * With formant preservation on, the spectral envelope (found by liftering the cepstrum) stays where it was
+     * and only the partials under it move, so voices don't sound like chipmunks.
+     *
+     * Latency is one frame: about 21ms in `LOW_LATENCY` mode and 85ms in `QUALITY` mode. All memory is
+     * allocated in the constructor.
+     *
+     * @tparam T floating-point type
+     */
+    template <typename T>
+    class PitchShifter : public STFT<T> {
+    public:
+        enum class Mode {
+            LOW_LATENCY, // ~21ms frames with 4x overlap
+            QUALITY // ~85ms frames with 8x overlap, better resolution for low notes
+        };
+
+    private:
+        int sampleRate;
+        float pitchRatio = 1.f;
+        bool preserveFormants = false;
+
+        //Per-bin arrays (all in one allocation, see `allocate()`)
+        T* pParams = nullptr;
+        T *magnitude, *phase, *lastPhase, *frequency, //analysis
+            *synthPhase, *lastSynthPhase, //synthesis phase of each output bin, this frame and last frame
+            *envelope, *zeros, //formant preservation
+            *owner; //magnitude of the peak whose region wrote each output bin this frame
+        static const int numParams = 9;
+        T* pCepstrum = nullptr; //frameSize scratch
+        int* pPeaks = nullptr;
+
+        /**
+         * @brief Wraps a phase to [-pi, pi]
+         */
+        static T wrapPhase(T x) {
+            return x - M_2PI * ::round(x / M_2PI);
+        }
+
+        static int frameSizeFor(int sampleRate, Mode mode) {
+            float seconds = (mode == Mode::QUALITY) ? 0.085f : 0.0213f;
+            int frameSize = 256;
+            while (frameSize < seconds * sampleRate) {
+                frameSize *= 2;
+            }
+            return frameSize;
+        }
+
+        void allocate() {
+            this->release();
+            this->pParams = (T*)::calloc(this->numBins * numParams, sizeof(T));
+            this->magnitude = this->pParams;
+            this->phase = this->magnitude + this->numBins;
+            this->lastPhase = this->phase + this->numBins;
+            this->frequency = this->lastPhase + this->numBins;
+            this->synthPhase = this->frequency + this->numBins;
+            this->lastSynthPhase = this->synthPhase + this->numBins;
+            this->envelope = this->lastSynthPhase + this->numBins;
+            this->zeros = this->envelope + this->numBins;
+            this->owner = this->zeros + this->numBins;
+            this->pCepstrum = (T*)::calloc(this->frameSize, sizeof(T));
+            this->pPeaks = (int*)::calloc(this->numBins, sizeof(int));
+        }
+
+        void release() {
+            ::free(this->pParams);
+            ::free(this->pCepstrum);
+            ::free(this->pPeaks);
+            this->pParams = this->pCepstrum = nullptr;
+            this->pPeaks = nullptr;
+        }
+
+        void copyFrom(const PitchShifter<T>& p) {
+            this->sampleRate = p.sampleRate;
+            this->pitchRatio = p.pitchRatio;
+            this->preserveFormants = p.preserveFormants;
+            this->allocate();
+            ::memcpy(this->pParams, p.pParams, this->numBins * numParams * sizeof(T));
+        }
+
+        /**
+         * @brief Smooth spectral envelope: the low quefrencies of the cepstrum (log magnitude -> IFFT),
+         * transformed back. Anything faster than ~1ms in the cepstrum (the harmonics of notes below 1kHz) is removed
+         */
+        void calculateEnvelope() {
+            for (int k = 0; k < this->numBins; k++) {
+                this->envelope[k] = ::log(this->magnitude[k] + T(1e-9));
+            }
+            this->fft.inverseReal(this->envelope, this->zeros, this->pCepstrum);
+            int cutoff = giml::clip<int>(this->sampleRate / 1000, 1, this->frameSize / 2 - 1);
+            for (int n = cutoff; n <= this->frameSize - cutoff; n++) {
+                this->pCepstrum[n] = 0;
+            }
+            this->fft.forwardReal(this->pCepstrum, this->envelope, this->zeros);
+            for (int k = 0; k < this->numBins; k++) {
+                this->envelope[k] = ::exp(this->envelope[k]);
+                this->zeros[k] = 0;
+            }
+        }
+
+    protected:
+        void processFrame(T* re, T* im, int numBins) override {
+            //Analysis: magnitude, phase and the true frequency of each bin (in bins) from its phase advance
+            T expected = M_2PI * this->hopSize / this->frameSize; //phase advance of bin 1 per hop
+            for (int k = 0; k < numBins; k++) {
+                this->magnitude[k] = ::sqrt(re[k] * re[k] + im[k] * im[k]);
+                this->phase[k] = ::atan2(im[k], re[k]);
+                T deviation = wrapPhase(this->phase[k] - this->lastPhase[k] - k * expected);
+                this->frequency[k] = k + deviation / expected;
+                this->lastPhase[k] = this->phase[k];
+            }
+            if (this->preserveFormants) {
+                this->calculateEnvelope();
+            }
+
+            //Find the peaks
+            int numPeaks = 0;
+            for (int k = 1; k < numBins - 1; k++) {
+                if (this->magnitude[k] > this->magnitude[k - 1] && this->magnitude[k] >= this->magnitude[k + 1]) {
+                    this->pPeaks[numPeaks++] = k;
+                }
+            }
+
+            //Move each peak's region (halfway to the neighbouring peaks) to the peak's new bin. Shifted regions
+            //overlap when pitching down, so each output bin goes to the strongest peak that reaches it
+            ::memset(re, 0, numBins * sizeof(T));
+            ::memset(im, 0, numBins * sizeof(T));
+            ::memset(this->owner, 0, numBins * sizeof(T));
+            ::memcpy(this->lastSynthPhase, this->synthPhase, numBins * sizeof(T)); //bins no region writes keep their phase
+            for (int i = 0; i < numPeaks; i++) {
+                int peak = this->pPeaks[i];
+                int shift = (int)::round(peak * this->pitchRatio) - peak;
+                int target = peak + shift;
+                if (target <= 0 || target >= numBins) {
+                    continue;
+                }
+                int start = (i == 0) ? 0 : (this->pPeaks[i - 1] + peak + 1) / 2;
+                int end = (i == numPeaks - 1) ? numBins : (peak + this->pPeaks[i + 1] + 1) / 2;
+
+                T peakPhase = this->lastSynthPhase[target] + expected * this->frequency[peak] * this->pitchRatio;
+                peakPhase = wrapPhase(peakPhase);
+                for (int k = giml::clip<int>(start, -shift, numBins - 1); k < end && k + shift < numBins; k++) {
+                    int out = k + shift;
+                    if (this->magnitude[peak] <= this->owner[out]) {
+                        continue; //a stronger peak's region already owns this bin
+                    }
+                    this->owner[out] = this->magnitude[peak];
+                    T p = peakPhase + (this->phase[k] - this->phase[peak]); //identity phase locking
+                    T m = this->magnitude[k];
+                    if (this->preserveFormants) {
+                        m *= giml::clip<T>(this->envelope[out] / (this->envelope[k] + T(1e-9)), 0, 10); //don't blow up quiet bins
+                    }
+                    re[out] = m * ::cos(p);
+                    im[out] = m * ::sin(p);
+                    this->synthPhase[out] = p;
+                }
+            }
+        }
+
+    public:
+        //Constructor
+        PitchShifter() = delete;
+        /**
+         * @param sampleRate sample rate of your project
+         * @param mode trade latency for frequency resolution
+         */
+        PitchShifter(int sampleRate, Mode mode = Mode::QUALITY) :
+            STFT<T>(frameSizeFor(sampleRate, mode), frameSizeFor(sampleRate, mode) / ((mode == Mode::QUALITY) ? 8 : 4)),
+            sampleRate(sampleRate) {
+            this->allocate();
+        }
+        //Copy constructor
+        PitchShifter(const PitchShifter<T>& p) : STFT<T>(p) {
+            this->copyFrom(p);
+        }
+        //Copy assignment operator
+        PitchShifter<T>& operator=(const PitchShifter<T>& p) {
+            if (this != &p) {
+                STFT<T>::operator=(p);
+                this->copyFrom(p);
+            }
+            return *this;
+        }
+        //Destructor
+        ~PitchShifter() {
+            this->release();
+        }
+
+        /**
+         * @brief Set the pitch change ratio
+         * @param ratio of desired pitch to input (2 is an octave up, 0.5 an octave down)
+         */
+        void setPitchRatio(float ratio) {
+            this->pitchRatio = giml::clip<float>(ratio, 0.25f, 4.f);
+        }
+
+        /**
+         * @brief Set the pitch change in semitones
+         * @param semitones desired pitch change
+         */
+        void setSemitones(float semitones) {
+            this->setPitchRatio(::powf(2.f, semitones / 12.f));
+        }
+
+        /**
+         * @brief Keep the spectral envelope in place while the pitch moves
+         * @param preserve whether to preserve formants
+         */
+        void setFormantPreservation(bool preserve) {
+            this->preserveFormants = preserve;
+        }
+
+        /**
+         * @brief Clears the input history, pending output and phase state
+         */
+        void reset() {
+            STFT<T>::reset();
+            ::memset(this->pParams, 0, this->numBins * numParams * sizeof(T));
+        }
+    };
+}
+#endif
@@ -1,9 +1,125 @@
 #ifndef GIML_REVERB_HPP
 #define GIML_REVERB_HPP
+#include <atomic>
 #include "utility.hpp"
 #include "oscillator.hpp"
+#include "modbus.hpp"
 #include "biquad.hpp"
 namespace giml {
+    /**
+     * @brief Use this enum type to specify what type of default room you want your reverb sounding like
+     * 
+     */
+    enum class RoomType {
+        CUBE, SPHERE, //TODO: Add more/better later
+        SQUARE_PYRAMID, CYLINDER,
+        CUSTOM
+    };
+
+    /**
+     * @brief Calculates the decay time of a simple "room" model (shared by `giml::Reverb` and `giml::FDNReverb`)
+     * 
+     * Reverb is supposed to make it sound like a bunch of echoes bouncing off of
+     * walls (hence delay lines)
+     *
+     * We will somewhat model a "room" that has some volume, some surface area (related
+     * to each other in ways that signify different room shapes) and an average absorption
+     * coefficient
+     *
+     * absorptionCoeff = 1 represents that the sound was completely absorbed by the room
+     *
+     * TODO: Find out more about absorptionCoefficient defaults
+     *
+     * This equation gives us decay time of the signal:
+     * RT-60 = V/(2 * SA * absorptionCoefficient)
+     * volume (ft^3), surface area (ft^2),
+     *
+     * Some basic shapes:
+     * Cube: V = s^3, SA = 6s^2
+     * Sphere: V = 4/3 pi r^3, SA = 4 pi r^2
+     * Cylinder: V = 1/3 pi r^2 h, SA = 2pi r h + 2pi r^2 (assume h = r though)
+     * Square Pyramid: V = 1/3 s^2 h, SA = a^2 + 2a sqrt{a^2/4 + h^2} (assume h = s though)
+     * 
+     * @param length either the side or radius of whatever shape you have chosen (in feet)
+     * @param absorptionCoefficient [0, 1] average absorption of the room's surfaces
+     * @param type preset shape of room
+     * @return RT-60 decay time in seconds
+     */
+    inline float roomRT60(float length, float absorptionCoefficient, RoomType type) {
+        float RT60 = 0.f;
+        switch (type) {
+            //Simplified V/SA formulas:
+        case RoomType::SPHERE: {
+            RT60 = length / (6 * absorptionCoefficient);
+            break;
+        }
+        case RoomType::CUBE: {
+            RT60 = length / (12 * absorptionCoefficient);
+            break;
+        }
+        case RoomType::SQUARE_PYRAMID: {
+            //Sand Pyramids absorb a lot more than brick walls, say 0.7-0.9 vs 0.02 for brick
+            RT60 = length / (6 * (1 + ::sqrtf(5)) * absorptionCoefficient);
+            break;
+        }
+        case RoomType::CYLINDER: {
+            RT60 = length / (8 * absorptionCoefficient);
+            break;
+        }
+        default:
+            break;
+        }
+        return RT60;
+    }
+
+    /**
+     * @brief Calculates the feedback gain that makes a delay line decay by 60dB over `RT60` seconds:
+     * g = 10^{\frac{-3D}{RT60 * sampleFreq}}
+     * @param delaySamples length of the delay line in samples
+     * @param sampleRate sample rate of your project
+     * @param RT60 decay time in seconds
+     * @return feedback gain
+     */
+    inline float rt60FeedbackGain(float delaySamples, int sampleRate, float RT60) {
+        return ::powf(10, -3 * delaySamples / (sampleRate * RT60));
+    }
+
+    /**
+     * @brief The inverse of `rt60FeedbackGain()`: how long a delay line takes to decay by 60dB when every trip
+     * around its loop multiplies the signal by `loopGain`
+     * @param delaySamples length of the delay line in samples
+     * @param sampleRate sample rate of your project
+     * @param loopGain gain per trip. With a one-pole LPF `y += lpf_G * (y_1 - y)` in the loop, pass its gain at DC,
+     * `g / (1 - lpf_G)`, since low frequencies decay the slowest
+     * @return decay time in seconds (`INFINITY` for a loop gain of 1 or more)
+     */
+    inline float feedbackRT60(float delaySamples, int sampleRate, float loopGain) {
+        loopGain = ::fabs(loopGain);
+        if (loopGain >= 1) {
+            return INFINITY;
+        }
+        if (loopGain == 0) {
+            return 0.f;
+        }
+        return -3 * delaySamples / (sampleRate * ::log10f(loopGain));
+    }
+
+    /**
+     * @brief Spreads `count` delay times between `maxDelay` and `maxDelay / 1.5` using tangential
+     * interpolation so that they share no easy common factors (see `Reverb::calculateTime()` for the derivation)
+     * @param maxDelay longest delay (in samples)
+     * @param count number of delay times to calculate
+     * @param delays output array of `count` delay times
+     */
+    inline void spreadDelayTimes(float maxDelay, int count, float* delays) {
+        delays[0] = maxDelay; //They give us max
+        delays[count - 1] = delays[0] / 1.5f; //We know min because of the ratio restriction
+        float division = M_PI_4 / (count - 1); // (pi/4)/number of intermediate delays we have left
+        for (int i = 1; i < count - 1; i++) { //Fill in the rest, order does not matter
+            delays[i] = delays[0] * (::tanf(i * division) + 2) / 3; //maxDelay * intermediate multiplier
+        }
+    }
+
 
     /**
      * @brief Reverb Effect
@@ -30,43 +146,164 @@ namespace giml {
         class NestedAPF;
 
         template <typename U>
-        class CombFilter;
+        class CombFilterBank;
 
-        //Parallel comb filters array
+        //Parallel comb filters (one structure-of-arrays bank)
         int numCombFilters;
-        DynamicArray<CombFilter<T>> parallelCombFilters;
+        CombFilterBank<T> parallelCombFilters;
 
         //Series APF arrays (one for before the comb filters and one for after)
         int numBeforeAPFs, numAfterAPFs;
         DynamicArray<NestedAPF<T>*> beforeAPFs, afterAPFs;
+        giml::ModTap<T> modTap; //shared LFO for the APFs, see `setModSource()`
+        giml::SilenceDetector<T> silence; //see `setIdleDetection()`
+        float tailLength = 0.f;
+
+        /**
+         * @brief Everything `setParams()` calculates: the parameters plus every comb/APF delay and gain.
+         * The arrays live in one allocation made in the constructor, so filling a set never allocates
+         */
+        struct Coefficients {
+            float time = 0.f, regen = 0.f, damping = 0.f, length = 1.f;
+            float tail = 0.f; //seconds until the output has decayed by 60dB, see `getTailLength()`
+            float* pData = nullptr;
+            float *combDelay, *combFeedback, *combLPF; //numCombFilters each
+            float *apfDelay, *apfFeedback; //numBeforeAPFs + numAfterAPFs each (before APFs first)
+        };
+
+        /**
+         * Three sets handed between the control thread (`prepareParams()`) and the audio thread (`processSample()`):
+         * the audio thread owns `front`, the control thread owns `back`, and `middle` is swapped atomically with
+         * either side. The `newCoefficients` flag in `middleIndex` marks a set that the audio thread hasn't picked up yet
+         */
+        Coefficients coefficients[3];
+        int frontIndex = 0; //audio thread only
+        int backIndex = 1; //control thread only
+        float preparedLength = 1.f; //control thread only, room length of the last `prepareParams()` (custom rooms keep it)
+        std::atomic<int> middleIndex{ 2 };
+        static const int newCoefficients = 4;
+
+        void allocateCoefficients() {
+            int numAPFs = this->numBeforeAPFs + this->numAfterAPFs;
+            for (auto& c : this->coefficients) {
+                c.pData = (float*)::calloc(3 * this->numCombFilters + 2 * numAPFs, sizeof(float));
+                c.combDelay = c.pData;
+                c.combFeedback = c.combDelay + this->numCombFilters;
+                c.combLPF = c.combFeedback + this->numCombFilters;
+                c.apfDelay = c.combLPF + this->numCombFilters;
+                c.apfFeedback = c.apfDelay + numAPFs;
+            }
+        }
+
+        void copyCoefficients(const Reverb<T>& r) { //Both reverbs must have the same number of combs/APFs
+            int numFloats = 3 * this->numCombFilters + 2 * (this->numBeforeAPFs + this->numAfterAPFs);
+            for (int i = 0; i < 3; i++) {
+                this->coefficients[i].time = r.coefficients[i].time;
+                this->coefficients[i].regen = r.coefficients[i].regen;
+                this->coefficients[i].damping = r.coefficients[i].damping;
+                this->coefficients[i].length = r.coefficients[i].length;
+                this->coefficients[i].tail = r.coefficients[i].tail;
+                ::memcpy(this->coefficients[i].pData, r.coefficients[i].pData, numFloats * sizeof(float));
+            }
+            this->frontIndex = r.frontIndex;
+            this->backIndex = r.backIndex;
+            this->preparedLength = r.preparedLength;
+            this->middleIndex.store(r.middleIndex.load());
+        }
+
+        void freeCoefficients() {
+            for (auto& c : this->coefficients) {
+                ::free(c.pData);
+                c.pData = nullptr;
+            }
+        }
         NestedAPF<T>* createNestedAPF(int sampleRate, int nestingDepth = 0) { //Uses `new`, must be properly deallocated in the Destructor
-            NestedAPF<T>* pCurrentAPF = nullptr;
-            for (int i = 0; i < nestingDepth + 1; i++) {
-                pCurrentAPF = new NestedAPF<T>{ sampleRate, pCurrentAPF };
+            return new NestedAPF<T>{ sampleRate, nestingDepth }; //All nesting levels live in this one object
+        }
+
+        void copyAPFs(const Reverb<T>& r) { //Deep copy so that both reverbs own (and delete) their own APFs
+            for (const auto& p : r.beforeAPFs) {
+                this->beforeAPFs.pushBack(new NestedAPF<T>{ *p });
+            }
+            for (const auto& p : r.afterAPFs) {
+                this->afterAPFs.pushBack(new NestedAPF<T>{ *p });
+            }
+        }
+
+        void deleteAPFs() {
+            //APFs are allocated on heap to persist through calls
+            while (this->beforeAPFs.size() > 0) {
+                delete this->beforeAPFs.popBack();
             }
+            while (this->afterAPFs.size() > 0) {
+                delete this->afterAPFs.popBack();
+            }
+        }
 
-            return pCurrentAPF;
+        /**
+         * @brief Before APFs -> parallel combs -> after APFs, with `apfProcess(apf, x)` running each APF
+         */
+        template <typename APFProcess>
+        inline T processAll(T in, APFProcess apfProcess) {
+            T prev = in;
+            if (this->numBeforeAPFs > 0) {
+                for (auto& apf : this->beforeAPFs) {
+                    prev = apfProcess(apf, prev);
+                }
+            }
+            // And then the comb filters
+            T summedValue = this->parallelCombFilters.processSample(prev);
+            summedValue /= this->numCombFilters; //Need to add this to make sure our signal stays within bounds
+            //And then finally insert summedValue into the last set of comb filters
+            if (this->numAfterAPFs > 0) {
+                for (auto& apf : this->afterAPFs) {
+                    summedValue = apfProcess(apf, summedValue);
+                    //prev = apf->processSample(prev);
+                }
+            }
+            return summedValue;
+        }
+
+        /**
+         * @brief Keeps every delay line moving while idle (see `setIdleDetection()`), as if it had processed silence
+         */
+        void writeSilence(int numSamples) {
+            this->parallelCombFilters.writeSilence(numSamples);
+            for (int i = 0; i < this->numBeforeAPFs; i++) {
+                this->beforeAPFs[i]->writeSilence(numSamples);
+            }
+            for (int i = 0; i < this->numAfterAPFs; i++) {
+                this->afterAPFs[i]->writeSilence(numSamples);
+            }
+        }
+
+        inline T process(T in) {
+            //this->delayLineInput.writeSample(in);
+            if (!(this->enabled)) {
+                return in;
+            }
+            if (this->modTap.isConnected()) {
+                T lfo = this->modTap.next(); //one shared LFO value for every APF
+                return this->processAll(in, [lfo](NestedAPF<T>* apf, T x) { return apf->processSample(x, lfo); });
+            }
+            return this->processAll(in, [](NestedAPF<T>* apf, T x) { return apf->processSample(x); });
         }
     
     public:
         //Constructor - creates all APFs/Comb Filters and puts them in place
         Reverb() = delete;
         Reverb(int sampleRate, int numBeforeAPFs = 2, int numCombFilters = 20, int numAfterAPFs = 2, int APFNestingDepth = 2) : sampleRate(sampleRate),
-        numBeforeAPFs(numBeforeAPFs), numCombFilters(numCombFilters), numAfterAPFs(numAfterAPFs) {
+        numCombFilters(numCombFilters), parallelCombFilters(sampleRate, numCombFilters), //Since all comb filters are in parallel, they'll use the same delay line input
+        numBeforeAPFs(numBeforeAPFs), numAfterAPFs(numAfterAPFs) {
+            //Comb filters are altered in phase when feedback gains are set in `.setRoom()`
             for (int i = 0; i < numBeforeAPFs; i++) {
                 this->beforeAPFs.pushBack(this->createNestedAPF(sampleRate, APFNestingDepth)); //Let's try nesting depth of 1 first
             }
-            
-            for (int i = 0; i < numCombFilters; i++) {
-                //Since all comb filters are in parallel, they'll use the same delay line input
-                this->parallelCombFilters.pushBack(CombFilter<T>(sampleRate, (i%2))); //Initialize the n comb filters
-                //Comb filters are altered in phase when feedback gains are set in `.setRoom()`
-            }
 
             for (int i = 0; i < numAfterAPFs; i++) {
                 this->afterAPFs.pushBack(this->createNestedAPF(sampleRate, 2));
             }
-            
+            this->allocateCoefficients();
         }
         //Copy constructor
         Reverb(const Reverb<T>& r) {
@@ -82,9 +319,12 @@ namespace giml {
             this->numAfterAPFs = r.numAfterAPFs;
 
             this->parallelCombFilters = r.parallelCombFilters;
-            this->beforeAPFs = r.beforeAPFs;
-            this->afterAPFs = r.afterAPFs;
-
+            this->modTap = r.modTap;
+            this->silence = r.silence;
+            this->tailLength = r.tailLength;
+            this->copyAPFs(r);
+            this->allocateCoefficients();
+            this->copyCoefficients(r);
         }
         Reverb<T>& operator=(const Reverb<T>& r) {
             this->sampleRate = r.sampleRate;
@@ -99,42 +339,41 @@ namespace giml {
             this->numAfterAPFs = r.numAfterAPFs;
 
             this->parallelCombFilters = r.parallelCombFilters;
-            this->beforeAPFs = r.beforeAPFs;
-            this->afterAPFs = r.afterAPFs;
+            this->modTap = r.modTap;
+            this->silence = r.silence;
+            this->tailLength = r.tailLength;
+            this->deleteAPFs();
+            this->copyAPFs(r);
+            this->freeCoefficients();
+            this->allocateCoefficients();
+            this->copyCoefficients(r);
 
             return *this;
         }
         //Destructor
         ~Reverb() {
-            //APFs are allocated on heap to persist through calls
-            for (const auto& p : this->beforeAPFs) {
-                delete p;
-            }
-            for (const auto& p : this->afterAPFs) {
-                delete p;
-            }
+            this->deleteAPFs();
+            this->freeCoefficients();
         }
         
         /**
          * @brief Use this enum type to specify what type of default room you want your reverb sounding like
          * 
          */
-        enum class RoomType {
-            CUBE, SPHERE, //TODO: Add more/better later
-            SQUARE_PYRAMID, CYLINDER,
-            CUSTOM
-        };
+        using RoomType = giml::RoomType;
 
         /**
          * @brief Abstract class to override and provide your own volume and surface area methods:
          * - `getVolume()` return a fixed volume of the same type that `Reverb` is using
          * - `getSurfaceArea()` return a fixed surface area of the same type that `Reverb` is using
+         * - `getAbsorptionCoefficient()` (optional) return how much the walls absorb, [0, 1]
          * 
          */
         class CustomRoom {
         public:
             virtual T getVolume() = 0;
             virtual T getSurfaceArea() = 0;
+            virtual T getAbsorptionCoefficient() { return 0.75; }
         };
 
 
@@ -153,18 +392,55 @@ namespace giml {
          * @see giml::Reverb::setRoom()
          */
         void setParams(float time, float regen, float damping, float roomLength = 1.f, float absorptionCoefficient = 0.75f, RoomType roomType = RoomType::SPHERE) {
-            this->setTime(time);
-            this->setRegen(regen);
-            this->setRoom(roomLength, absorptionCoefficient, roomType);
-            this->setDamping(damping);
+            Coefficients& c = this->coefficients[this->frontIndex];
+            if (roomLength < 0) {
+                roomLength = 0;
+            }
+            this->calculateParams(c, time, regen, damping, roomLength, giml::roomRT60(roomLength, absorptionCoefficient, roomType));
+            this->applyCoefficients(c);
         }
 
         void setParams(float time, float regen, float damping, CustomRoom* customRoom = nullptr) {
-            this->setTime(time);
-            this->setRegen(regen);
-            this->setRoom(customRoom);
-            this->setDamping(damping);
+            Coefficients& c = this->coefficients[this->frontIndex];
+            this->calculateParams(c, time, regen, damping, this->param__length, this->customRT60(customRoom));
+            this->applyCoefficients(c);
         }
+
+        /**
+         * @brief Same as `setParams()`, but safe to call from a control thread while the audio thread is processing
+         *
+         * Every delay and gain is calculated here into a spare coefficient set, which is then published with one
+         * atomic exchange. The audio thread picks up the newest published set at the start of its next
+         * `processSample()`/`processBlock()` and only copies it into the filters: no allocation, no `powf()`/`tanf()`
+         * and no locks. Only one thread may call `prepareParams()`, and `setParams()` should then only be called from
+         * the audio thread
+         * 
+         * @see giml::Reverb::setParams()
+         */
+        void prepareParams(float time, float regen, float damping, float roomLength = 1.f, float absorptionCoefficient = 0.75f, RoomType roomType = RoomType::SPHERE) {
+            Coefficients& c = this->coefficients[this->backIndex];
+            if (roomLength < 0) {
+                roomLength = 0;
+            }
+            this->preparedLength = roomLength;
+            this->calculateParams(c, time, regen, damping, roomLength, giml::roomRT60(roomLength, absorptionCoefficient, roomType));
+            this->publishCoefficients();
+        }
+
+        /**
+         * @brief `prepareParams()` with a user-defined room. The room length stays at the last one prepared
+         * @param customRoom room to take the volume, surface area and absorption from (must not be `nullptr`)
+         */
+        void prepareParams(float time, float regen, float damping, CustomRoom* customRoom) {
+            if (!customRoom) {
+                printf("Reverb::prepareParams() needs a CustomRoom, parameters unchanged\n");
+                return;
+            }
+            Coefficients& c = this->coefficients[this->backIndex];
+            this->calculateParams(c, time, regen, damping, this->preparedLength, this->customRT60(customRoom));
+            this->publishCoefficients();
+        }
+
         /**
          * @brief Function to process one sound sample through the `Reverb` effect at a time
          * 
@@ -172,31 +448,75 @@ namespace giml {
          * @return T floating-point (float or double) output
          */
         T processSample(T in) {
-            //this->delayLineInput.writeSample(in);
-            if (!(this->enabled)) {
+            this->updateCoefficients();
+            if (this->silence.isIdle() && this->silence.isSilent(in)) {
+                this->writeSilence(1);
                 return in;
             }
-            T prev = in;
-            if (this->numBeforeAPFs > 0) {
-                for (auto& apf : this->beforeAPFs) {
-                    prev = apf->processSample(prev);
-                }
+            T out = this->process(in);
+            if (this->silence.isActive()) {
+                this->silence.update(this->silence.isSilent(in) && this->silence.isSilent(out), 1);
             }
-            // And then the comb filters
-            T summedValue = 0;
-            for (auto& combFilter : this->parallelCombFilters) {
-                summedValue += combFilter.processSample(prev);
+            return out;
+        }
+
+        /**
+         * @brief Processes a block of samples, picking up parameters from `prepareParams()` once at the start
+         * 
+         * @param in input samples
+         * @param out output samples (may be the same as `in`)
+         * @param numSamples number of samples
+         */
+        void processBlock(const T* in, T* out, int numSamples) {
+            this->updateCoefficients();
+            bool silentIn = this->silence.isActive() && this->silence.isSilent(in, numSamples);
+            if (silentIn && this->silence.isIdle()) { //the tail has died away, only the delay lines move on
+                ::memmove(out, in, numSamples * sizeof(T));
+                this->writeSilence(numSamples);
+                return;
             }
-            summedValue /= this->numCombFilters; //Need to add this to make sure our signal stays within bounds
-            //And then finally insert summedValue into the last set of comb filters
-            if (this->numAfterAPFs > 0) {
-                for (auto& apf : this->afterAPFs) {
-                    summedValue = apf->processSample(summedValue);
-                    //prev = apf->processSample(prev);
-                }
+            for (int n = 0; n < numSamples; n++) {
+                out[n] = this->process(in[n]);
             }
-            return summedValue;
-            //return prev;
+            if (this->silence.isActive()) {
+                this->silence.update(silentIn && this->silence.isSilent(out, numSamples), numSamples);
+            }
+        }
+
+        /**
+         * @brief Lets the reverb idle once its input and tail are silent: silent input is then passed straight
+         * through without running any comb filter or APF (their delay lines are only filled with zeros, so
+         * longer delays set later can't bring back old audio), and the first sample with sound wakes it again.
+         * Before idling the output must stay silent for a whole tail length (see `getTailLength()`)
+         * @param on whether to idle (off by default)
+         * @param thresholdDB level below which a sample counts as silent
+         */
+        void setIdleDetection(bool on, float thresholdDB = -90.f) {
+            this->silence.setActive(on, thresholdDB);
+        }
+
+        /**
+         * @return whether the reverb is currently idling (see `setIdleDetection()`)
+         */
+        bool isIdle() const {
+            return this->silence.isIdle();
+        }
+
+        /**
+         * @return how long the slowest comb filter takes to decay by 60dB (longer than the room's RT60 with regen)
+         * plus the path through the APFs, in seconds
+         */
+        float getTailLength() override {
+            return this->tailLength;
+        }
+
+        /**
+         * @brief Modulate every APF's delay with a shared LFO instead of their own
+         * @param bus bus to read from (`nullptr` goes back to the APFs' own LFOs)
+         * @param source index returned by `ModBus::addSource()`
+         */
+        void setModSource(const giml::ModBus<T>* bus, int source = 0) {
+            this->modTap.connect(bus, source);
         }
 
         // void setAPFFeedback(float g) {
@@ -223,10 +543,11 @@ namespace giml {
         /**
          * @brief Takes the `time` value and calculates the delay indices for all the comb filters and the APFs
          * 
+         * @param c coefficient set to fill
          * @param t time in seconds (you'll want to pass in milliseconds instead to avoid accidental delay effects)
          */
-        inline void setTime(float t) { //in sec
-            this->param__time = t;
+        inline void calculateTime(Coefficients& c, float t) { //in sec
+            c.time = t;
             // Recalculate/set the delay indices
 
             /**
@@ -264,76 +585,45 @@ namespace giml {
              */
 
             //Comb Filter Delay Indices
-            float* delayIndices = (float*)::calloc(this->numCombFilters, sizeof(float));
-            //int delayIndices[this->numCombFilters] = {0};
-            delayIndices[0] = this->sampleRate * this->param__time; //They give us max
-            delayIndices[this->numCombFilters - 1] = delayIndices[0] / 1.5f; //We know min because of the ratio restriction
-            float division = M_PI_4 / (this->numCombFilters - 1); // (pi/4)/number of intermediate comb filters we have left
-            for (int i = 1; i < this->numCombFilters - 1; i++) { //Fill in the rest of the comb filters, order does not matter
-                delayIndices[i] = delayIndices[0] * (::tanf(i * division) + 2) / 3; //maxDelay * intermediate multiplier
-            }
-            //Actually set their new delay indices
-            for (int i = 0; i < this->numCombFilters; i++) {
-                this->parallelCombFilters[i].setDelayIndex(delayIndices[i]);
-            }
-
-            ::free(delayIndices);
+            giml::spreadDelayTimes(this->sampleRate * t, this->numCombFilters, c.combDelay); //They give us max
 
-            //TODO: Do what we need to do for APF
+            //Same for the APFs, a third as long
             int totalAPFs = this->numBeforeAPFs + this->numAfterAPFs;
             if (totalAPFs > 0) { //If we have any APFs to begin with
-                delayIndices = (float*)::calloc(totalAPFs, sizeof(float));
-                delayIndices[0] = (this->sampleRate * this->param__time)/3; //They give us max
-                delayIndices[totalAPFs - 1] = delayIndices[0] / 1.5f; //We know min because of the ratio restriction
-                float division = M_PI_4 / (totalAPFs - 1); // (pi/4)/number of intermediate comb filters we have left
-                for (int i = 1; i < totalAPFs - 1; i++) { //Fill in the rest of the comb filters, order does not matter
-                    delayIndices[i] = delayIndices[0] * (::tanf(i * division) + 2) / 3; //maxDelay * intermediate multiplier
-                }
-                //Actually set their new delay indices
-                for (int i = 0; i < this->numBeforeAPFs; i++) {
-                    this->beforeAPFs[i]->setDelaySamples(delayIndices[i]);
-                }
-                for (int i = 0; i < this->numAfterAPFs; i++) {
-                    this->afterAPFs[i]->setDelaySamples(delayIndices[this->numBeforeAPFs + i]);
-                }
-
-                ::free(delayIndices);
+                giml::spreadDelayTimes((this->sampleRate * t)/3, totalAPFs, c.apfDelay); //They give us max
             }
         }
         /**
-         * @brief Takes a feedback gain coefficient and sets the cutoff frequency of the low-pass filters present in the APFs
+         * @brief Takes a feedback gain coefficient for the low-pass filters present in the APFs
          * 
+         * @param c coefficient set to fill
          * @param g [0, 1) (non-inclusive because we need gain to be decaying for BIBO stability)
          */
-        inline void setDamping(float g) { // [0, 1)
+        inline void calculateDamping(Coefficients& c, float g) { // [0, 1)
             if (g < 0) {
                 g = 0;
             }
             else if (g >= 1) {
                 g = 0.97f;
             }
-
-            this->param__damping = g;
-            for (auto& apf : this->beforeAPFs) {
-                apf->setLPFFeedbackGain(g);
-            }
-            for (auto& apf : this->afterAPFs) {
-                apf->setLPFFeedbackGain(g);
-            }
+            c.damping = g;
         }
         /**
-         * @brief Takes a feedback gain coefficient and sets the parameter for all the comb filters
+         * @brief Takes a feedback gain coefficient and calculates the LPF gains for all the comb filters, and
+         * with them the tail length. Uses the comb feedback gains and every delay, so it must come after
+         * `calculateTime()` and `calculateFeedbackCoefficients()`
          * 
+         * @param c coefficient set to fill
          * @param regen [0, 1) (non-inclusive because we need gain to be decaying for BIBO stability)
          */
-        inline void setRegen(float regen) { // [0, 1) (non-inclusive because we need gain to be decaying for BIBO stability)
+        inline void calculateRegen(Coefficients& c, float regen) { // [0, 1) (non-inclusive because we need gain to be decaying for BIBO stability)
             if (regen < 0) {
                 regen = 0;
             }
             else if (regen >= 1) {
                 regen = 0.999999;
             }
-            this->param__regen = regen;
+            c.regen = regen;
             // Recalculate the g value from RT-60 and new damping
 
             /**
@@ -342,91 +632,33 @@ namespace giml {
              *
              */
 
-             //0 - 1  maps to 0 - sampleRate
-            //float cutoffFreq = (1 - regen) * this->sampleRate;
-
             //Set the LPF feedback gains
             for (int i = 0; i < this->numCombFilters; i++) {
-                float g = regen * (1 - ::fabs(this->parallelCombFilters[i].getCombFeedbackGain()));
-                this->parallelCombFilters[i].setLPFFeedbackGain(g);
-                //this->parallelCombFilters[i].setLPFCutoffFrequency(cutoffFreq);
-            }
-        }
-
-        /**
-         * @brief Takes the aspects of the room and calculates the Comb and APF feedback gains for a proper decay time for the reverb
-         * 
-         * @param length A either the side or radius of whatever shape you have chosen
-         * @param absorptionCoefficient The average absorption of all the collective surfaces in this fake room (0 is completely reflective and 1 is completely absorbive)
-         * @param type Pick from any of the default room types
-         * @param customRoom If you set CUSTOM in the previous field, you must specify a pointer to your custom room object so that we can properly calculate the proper feedback coefficients
-         */
-        inline void setRoom(float length, float absorptionCoefficient = 0.75f, RoomType type = RoomType::SPHERE) {
-            //Length in feet (ft)
-            if (length < 0) {
-                length = 0;
+                c.combLPF[i] = regen * (1 - ::fabs(c.combFeedback[i]));
             }
-            this->param__length = length;
-            // recalculate the RT-60 decay time and the comb filter gains
 
-            /**
-             * @brief Overview of "room" acoustics
-             * Reverb is supposed to make it sound like a bunch of echoes bouncing off of
-             * walls (hence delay lines)
-             *
-             * We will somewhat model a "room" that has some volume, some surface area (related
-             * to each other in ways that signify different room shapes) and an average absorption
-             * coefficient
-             *
-             * absorptionCoeff = 1 represents that the sound was completely absorbed by the room
-             *
-             * TODO: Find out more about absorptionCoefficient defaults
-             *
-             * This equation gives us decay time of the signal:
-             * RT-60 = V/(2 * SA * absorptionCoefficient)
-             * volume (ft^3), surface area (ft^2),
-             *
-             * Some basic shapes:
-             * Cube: V = s^3, SA = 6s^2
-             * Sphere: V = 4/3 pi r^3, SA = 4 pi r^2
-             * Cylinder: V = 1/3 pi r^2 h, SA = 2pi r h + 2pi r^2 (assume h = r though)
-             * Square Pyramid: V = 1/3 s^2 h, SA = a^2 + 2a sqrt{a^2/4 + h^2} (assume h = s though)
-             */
-            float RT60 = 0.f;
-            switch (type) {
-                //Simplified V/SA formulas:
-            case RoomType::SPHERE: {
-                RT60 = length / (6 * absorptionCoefficient);
-                break;
-            }
-            case RoomType::CUBE: {
-                RT60 = length / (12 * absorptionCoefficient);
-                break;
-            }
-            case RoomType::SQUARE_PYRAMID: {
-                //Sand Pyramids absorb a lot more than brick walls, say 0.7-0.9 vs 0.02 for brick
-                RT60 = length / (6 * (1 + ::sqrtf(5)) * absorptionCoefficient);
-                break;
-            }
-            case RoomType::CYLINDER: {
-                RT60 = length / (8 * absorptionCoefficient);
-                break;
+            //The tail lasts until the slowest comb has decayed by 60dB and its output has made it through every APF.
+            //The LPF raises a comb's loop gain at DC to g/(1-lpf_G), so regen makes the room ring longer than its RT60
+            float longestComb = 0.f;
+            for (int i = 0; i < this->numCombFilters; i++) {
+                float loopGain = c.combFeedback[i] / (1 - c.combLPF[i]);
+                float decay = c.combDelay[i] / this->sampleRate + giml::feedbackRT60(c.combDelay[i], this->sampleRate, loopGain);
+                longestComb = (decay > longestComb) ? decay : longestComb;
             }
+            float apfPath = 0.f;
+            for (int i = 0; i < this->numBeforeAPFs + this->numAfterAPFs; i++) {
+                apfPath += c.apfDelay[i];
             }
-
-            this->calculateAndSetFeedbackCoefficients(RT60);
+            c.tail = longestComb + apfPath / this->sampleRate;
         }
+
         /**
-         * @brief Call this function if they specify a custom room object instead
+         * @brief Calculates the Comb and APF feedback gains for a proper decay time for the reverb
          * 
-         * @param customRoom You must specify a pointer to your custom room object so that we can properly calculate the proper feedback coefficients
+         * @param c coefficient set to fill (its delay indices must already be calculated)
+         * @param RT60 decay time in seconds (see `giml::roomRT60()`)
          */
-        inline void setRoom(CustomRoom* customRoom = nullptr) {
-            float RT60 = customRoom->getVolume() / (2 * customRoom->getSurfaceArea() * customRoom->getAbsorptionCoefficient());
-            this->calculateAndSetFeedbackCoefficients(RT60);
-        }
-
-        inline void calculateAndSetFeedbackCoefficients(float RT60) {
+        inline void calculateFeedbackCoefficients(Coefficients& c, float RT60) {
             /**
              *
              * Calculating the comb filter feedback gain follows the equation:
@@ -435,246 +667,456 @@ namespace giml {
 
              //Set comb feedback gains corresponding to the newly calculated RT60 decay time
             for (int i = 0; i < this->numCombFilters; i++) {
-                float delayIndex = this->parallelCombFilters[i].getDelayIndex();
-                float feedbackGain = ::powf(10, -3 * delayIndex / (this->sampleRate * RT60));
+                float feedbackGain = giml::rt60FeedbackGain(c.combDelay[i], this->sampleRate, RT60);
                 // if (feedbackGain > 0.95) {
                 //     feedbackGain = 0.95;
                 // } //TODO: Find a better way to clamp or be more precise
                 //Flip the phase of every other comb filter
-                if (i % 2) {
-                    this->parallelCombFilters[i].setCombFeedbackGain(-feedbackGain);
-                    //this->parallelCombFilters[i].setLPFFeedbackGain(-this->parallelCombFilters[i].getLPFFeedbackGain())
-                }
-                else {
-                    this->parallelCombFilters[i].setCombFeedbackGain(feedbackGain);
-                    //this->parallelCombFilters[i].setLPFFeedbackGain(-this->parallelCombFilters[i].getLPFFeedbackGain())
-                }
-
+                c.combFeedback[i] = (i % 2) ? -feedbackGain : feedbackGain;
             }
 
             //Do what we need to do for APF
-            for (int i = 0; i < this->numBeforeAPFs; i++) {
-                float delayIndex = this->beforeAPFs[i]->getDelaySamples();
-                float feedbackGain = ::powf(10, -3 * delayIndex / (this->sampleRate * RT60))/2;
-                this->beforeAPFs[i]->setAPFFeedbackGain(-feedbackGain);
+            for (int i = 0; i < this->numBeforeAPFs + this->numAfterAPFs; i++) {
+                float feedbackGain = giml::rt60FeedbackGain(c.apfDelay[i], this->sampleRate, RT60) / 2;
+                c.apfFeedback[i] = -feedbackGain;
             }
-            for (int i = 0; i < this->numAfterAPFs; i++) {
-                float delayIndex = this->afterAPFs[i]->getDelaySamples();
-                float feedbackGain = ::powf(10, -3 * delayIndex / (this->sampleRate * RT60)) / 2;
-                this->afterAPFs[i]->setAPFFeedbackGain(-feedbackGain);
+        }
+
+        /**
+         * @brief RT60 of a user-defined room (see `giml::roomRT60()` for the preset rooms)
+         */
+        float customRT60(CustomRoom* customRoom) {
+            return customRoom->getVolume() / (2 * customRoom->getSurfaceArea() * customRoom->getAbsorptionCoefficient());
+        }
+
+        /**
+         * @brief Fills a whole coefficient set. The comb feedback gains (from the room) are calculated
+         * before the regen LPF gains that depend on them
+         */
+        inline void calculateParams(Coefficients& c, float time, float regen, float damping, float roomLength, float RT60) {
+            c.length = roomLength;
+            this->calculateTime(c, time);
+            this->calculateFeedbackCoefficients(c, RT60);
+            this->calculateRegen(c, regen);
+            this->calculateDamping(c, damping);
+        }
+
+        /**
+         * @brief Copies a coefficient set into the comb filters and APFs. Plain stores only: no allocation or math
+         */
+        void applyCoefficients(const Coefficients& c) {
+            this->param__time = c.time;
+            this->param__regen = c.regen;
+            this->param__damping = c.damping;
+            this->param__length = c.length;
+            this->tailLength = c.tail;
+            this->silence.setHoldSamples(c.tail * this->sampleRate);
+            for (int i = 0; i < this->numCombFilters; i++) {
+                this->parallelCombFilters.setDelayIndex(i, c.combDelay[i]);
+                this->parallelCombFilters.setCombFeedbackGain(i, c.combFeedback[i]);
+                this->parallelCombFilters.setLPFFeedbackGain(i, c.combLPF[i]);
+            }
+            for (int i = 0; i < this->numBeforeAPFs + this->numAfterAPFs; i++) {
+                NestedAPF<T>* apf = (i < this->numBeforeAPFs) ? this->beforeAPFs[i] : this->afterAPFs[i - this->numBeforeAPFs];
+                apf->setDelaySamples(c.apfDelay[i]);
+                apf->setAPFFeedbackGain(c.apfFeedback[i]);
+                apf->setLPFFeedbackGain(c.damping);
             }
         }
 
         /**
-         * @brief An N-th order All-Pass Filter (APF) with functionality to include another N-th order APF in its feedback loop (and continues recursively)
+         * @brief Control thread: hands the back set to the audio thread and takes the middle one to write next
+         */
+        void publishCoefficients() {
+            this->backIndex = this->middleIndex.exchange(this->backIndex | newCoefficients, std::memory_order_acq_rel) & ~newCoefficients;
+        }
+
+        /**
+         * @brief Audio thread: if a new set was published, swaps it in as the front set and applies it
+         */
+        inline void updateCoefficients() {
+            if (this->middleIndex.load(std::memory_order_relaxed) & newCoefficients) {
+                this->frontIndex = this->middleIndex.exchange(this->frontIndex, std::memory_order_acq_rel) & ~newCoefficients;
+                this->applyCoefficients(this->coefficients[this->frontIndex]);
+            }
+        }
+
+        /**
+         * @brief An N-th order All-Pass Filter (APF) with further APFs nested in its feedback loop, stored flat.
+         * 
+         * Nesting level 0 is the outermost APF and level `numLevels - 1` the innermost. Every level writes its
+         * delay line once per sample, so all levels share one slab interleaved by time (`pDelayLines[t * numLevels + k]`)
+         * and one write index, and per-level parameters/state are contiguous arrays. `processSample()` walks the levels
+         * iteratively (reads going in, writes coming back out) instead of recursing through separately allocated nodes
          * 
          * @tparam U 
          */
         template <typename U>
         class NestedAPF { //not the same as 2nd order APF present in Biquad since this is Nth-order
         private:
-            CircularBuffer<U> delayLine;
-            TriOsc<U> LFO; //TODO: We can try another oscillator?
-            NestedAPF<U>* nestedAPF; //Pointer to another nestedAPF inside this one's feedback loop
+            static const int lfoDepth = 10; //numSamples to go over/under by from original delay of delay line
+            static const int numParams = 8;
+
+            int numLevels = 0;
+            size_t lineLength = 0, writeIndex = 0;
+            U* pDelayLines = nullptr; //numLevels delay lines of lineLength samples, interleaved by time
+
+            //Per-level parameters and state (all in one allocation, see `allocate()`)
+            U* pParams = nullptr;
+            U *delaySamples, //delay in ms converted to how many samples in the past
+                *LPFFeedbackGain, *LPFLast, *APFFeedbackGain,
+                *lfoPhase, *lfoPhaseIncrement, //Triangle LFO per level (same waveshape as `TriOsc`) TODO: set LFO frequency
+                *delayed, *w; //scratch for the current sample
+
+            void allocate(int numLevels, size_t lineLength) {
+                this->release();
+                this->numLevels = numLevels;
+                this->lineLength = lineLength;
+                this->writeIndex = 0;
+                this->pDelayLines = (U*)::calloc(numLevels * lineLength, sizeof(U));
+                this->pParams = (U*)::calloc(numLevels * numParams, sizeof(U));
+                this->delaySamples = this->pParams;
+                this->LPFFeedbackGain = this->delaySamples + numLevels;
+                this->LPFLast = this->LPFFeedbackGain + numLevels;
+                this->APFFeedbackGain = this->LPFLast + numLevels;
+                this->lfoPhase = this->APFFeedbackGain + numLevels;
+                this->lfoPhaseIncrement = this->lfoPhase + numLevels;
+                this->delayed = this->lfoPhaseIncrement + numLevels;
+                this->w = this->delayed + numLevels;
+            }
+
+            void release() {
+                ::free(this->pDelayLines);
+                ::free(this->pParams);
+                this->pDelayLines = nullptr;
+                this->pParams = nullptr;
+            }
+
+            void copyFrom(const NestedAPF<U>& a) {
+                this->allocate(a.numLevels, a.lineLength);
+                this->writeIndex = a.writeIndex;
+                ::memcpy(this->pDelayLines, a.pDelayLines, a.numLevels * a.lineLength * sizeof(U));
+                ::memcpy(this->pParams, a.pParams, a.numLevels * numParams * sizeof(U));
+            }
+
+            /**
+             * @brief Same as `CircularBuffer::readSample(float)` on one level's delay line
+             */
+            inline U readSample(int level, float delayInSamples) const {
+                size_t readIndex = delayInSamples; // sample 1
+                size_t readIndex2 = readIndex + 1; // sample 2
+                float frac = delayInSamples - readIndex; // proportion of sample 2 to blend in
+                if (readIndex >= this->lineLength) { readIndex = this->lineLength - 1; } // limit delay to maxIndex
+                if (readIndex2 >= this->lineLength) { readIndex2 = this->lineLength - 1; }
+                long int i1 = this->writeIndex - readIndex, i2 = this->writeIndex - readIndex2;
+                if (i1 < 0) { i1 += this->lineLength; } // circular logic
+                if (i2 < 0) { i2 += this->lineLength; }
+
+                return  // do linear interpolation
+                    (this->pDelayLines[i1 * this->numLevels + level] * (1.f - frac))
+                    + (this->pDelayLines[i2 * this->numLevels + level] * frac);
+            }
+
         public:
             //Constructor
             NestedAPF() = delete;
-            //Allow NestedAPF to take in a pointer to NestedAPF for placement in the feedback loop of this current APF
-            NestedAPF(int sampleRate, NestedAPF<U>* nestedAPF = nullptr) : LFO(sampleRate), nestedAPF(nestedAPF) {
-                this->delayLine.allocate(5 * sampleRate);
-                //TODO: this->LFO.setFrequency();
+            /**
+             * @param sampleRate sample rate of your project
+             * @param nestingDepth number of APFs nested inside the outermost one
+             */
+            NestedAPF(int sampleRate, int nestingDepth = 0) {
+                this->allocate(nestingDepth + 1, 5 * sampleRate);
             }
             //Copy Constructor
             NestedAPF(const NestedAPF<U>& a) {
-                this->delayLine = a.delayLine;
-                this->LFO = a.LFO;
-                this->lfoDepth = a.lfoDepth;
-                this->nestedAPF = a.nestedAPF;
-
-                this->delaySamples = a.delaySamples;
-                this->LPFFeedbackGain = a.LPFFeedbackGain;
-                this->LPFLast = a.LPFLast;
-                this->APFFeedbackGain = a.APFFeedbackGain;
+                this->copyFrom(a);
             }
 
             // Copy assignment operator
             NestedAPF<U>& operator=(const NestedAPF<U>& a) {
-                this->delayLine = a.delayLine;
-                this->LFO = a.LFO;
-                this->lfoDepth = a.lfoDepth;
-                this->nestedAPF = a.nestedAPF;
-
-                this->delaySamples = a.delaySamples;
-                this->LPFFeedbackGain = a.LPFFeedbackGain;
-                this->LPFLast = a.LPFLast;
-                this->APFFeedbackGain = a.APFFeedbackGain;
-
+                if (this != &a) {
+                    this->copyFrom(a);
+                }
                 return *this;
             }
 
             ~NestedAPF() {
-                delete this->nestedAPF; //Make sure to deallocate this so that 
+                this->release();
             }
             /**
-             * @brief Sets the number of samples the delay starts at. It sets all nested APFs to have 1/4 that delay
+             * @brief Sets the number of samples the delay starts at. It sets the first nested APF to have 1/4 that delay
              * 
              * @param numSamples  (can be a float for interpolated samples)
              */
             void setDelaySamples(float numSamples) {
-                this->delaySamples = numSamples;
-                this->nestedAPF->delaySamples = numSamples/4;
+                this->delaySamples[0] = numSamples;
+                if (this->numLevels > 1) {
+                    this->delaySamples[1] = numSamples / 4;
+                }
             }
 
             float getDelaySamples() const {
-                return this->delaySamples;
+                return this->delaySamples[0];
             }
             /**
-             * @brief Sets the LPF Feedback gain for the embedded LPF(s) in this NestedAPF. Sets all nested ones to 1/4 (recursive)
+             * @brief Sets the LPF Feedback gain for the embedded LPF(s) in this NestedAPF. Sets the first nested one to 1/4
              * 
              * @param g 
              */
             void setLPFFeedbackGain(float g) {
-                this->LPFFeedbackGain = g;
-                this->nestedAPF->LPFFeedbackGain = g/4;
+                this->LPFFeedbackGain[0] = g;
+                if (this->numLevels > 1) {
+                    this->LPFFeedbackGain[1] = g / 4;
+                }
             }
             /**
-             * @brief Sets the actual APF's Feedback gain. Sets all nested ones to 1/4 (recursive)
+             * @brief Sets the actual APF's Feedback gain. Sets the first nested one to 1/4
              * 
              * @param g 
              */
             void setAPFFeedbackGain(float g) {
-                this->APFFeedbackGain = g;
-                this->nestedAPF->APFFeedbackGain = g/4;
+                this->APFFeedbackGain[0] = g;
+                if (this->numLevels > 1) {
+                    this->APFFeedbackGain[1] = g / 4;
+                }
             }
 
-            U processSample(U in) {
-
-                // Read previous sample from delay line (modulated by oscillator converted to unipolar through *0.5 + 0.5)
-                U delayedVal = this->delayLine.readSample(this->delaySamples + (this->LFO.processSample() + 1) / 2 * this->lfoDepth);
-
-                //Now go through LPF
-                delayedVal = delayedVal * (1 - this->LPFFeedbackGain) + this->LPFFeedbackGain * this->LPFLast;
-                this->LPFLast = delayedVal; //set next prev to current
-
-                U w = in + this->APFFeedbackGain * delayedVal;
+        private:
+            /**
+             * @brief One sample through every level, `lfo(k)` gives level `k`'s modulation in `[-1, 1]`
+             */
+            template <typename LFO>
+            inline U process(U in, LFO lfo) {
+                //Going in: each level reads its delay line and feeds `w` to the next level
+                U x = in;
+                for (int k = 0; k < this->numLevels; k++) {
+                    // Read previous sample from delay line (modulated by oscillator converted to unipolar through *0.5 + 0.5)
+                    U delayedVal = this->readSample(k, this->delaySamples[k] + (lfo(k) + 1) / 2 * lfoDepth);
+
+                    //Now go through LPF
+                    delayedVal = giml::undenormalize(delayedVal * (1 - this->LPFFeedbackGain[k]) + this->LPFFeedbackGain[k] * this->LPFLast[k]);
+                    this->LPFLast[k] = delayedVal; //set next prev to current
+
+                    this->delayed[k] = delayedVal;
+                    this->w[k] = x + this->APFFeedbackGain[k] * delayedVal;
+                    x = this->w[k];
+                }
 
-                if (this->nestedAPF) {
-                    //Then let's take our value through it
-                    U innerVal = this->nestedAPF->processSample(w);
-                    this->delayLine.writeSample(innerVal);
+                //Coming back out: the innermost level writes its own `w`, every other level writes its inner level's output
+                U* frame = this->pDelayLines + this->writeIndex * this->numLevels;
+                U y = x;
+                for (int k = this->numLevels - 1; k >= 0; k--) {
+                    frame[k] = giml::undenormalize(y);
+                    y = -this->APFFeedbackGain[k] * this->w[k] + this->delayed[k];
                 }
-                else {
-                    this->delayLine.writeSample(w);
+
+                this->writeIndex++;
+                if (this->writeIndex >= this->lineLength) {
+                    this->writeIndex = 0; // circular logic 
                 }
+                return y;
+            }
 
-                return -this->APFFeedbackGain * w + delayedVal;
+        public:
+            /**
+             * @brief Writes `numSamples` frames of zeros, see `CircularBuffer::writeSilence()`
+             */
+            void writeSilence(size_t numSamples) {
+                size_t toClear = (numSamples < this->lineLength) ? numSamples : this->lineLength;
+                size_t first = this->lineLength - this->writeIndex;
+                first = (toClear < first) ? toClear : first;
+                ::memset(this->pDelayLines + this->writeIndex * this->numLevels, 0, first * this->numLevels * sizeof(U));
+                ::memset(this->pDelayLines, 0, (toClear - first) * this->numLevels * sizeof(U));
+                this->writeIndex = (this->writeIndex + numSamples) % this->lineLength;
             }
-        private:
-            static const int lfoDepth = 10; //numSamples to go over/under by from original delay of delay line
-            float delaySamples = 0.f; //delay in ms converted to how many samples in the past
-            T LPFLast = 0;
-            float LPFFeedbackGain = 0.f, APFFeedbackGain = 0.f;
 
+            U processSample(U in) {
+                return this->process(in, [this](int k) {
+                    //Advance the LFO (see `Phasor::processSample()` and `TriOsc::processSample()`)
+                    this->lfoPhase[k] += this->lfoPhaseIncrement[k];
+                    if (this->lfoPhase[k] >= 1) { this->lfoPhase[k] -= 1; }
+                    return ::abs(this->lfoPhase[k] * 2 - 1) * 2 - 1;
+                });
+            }
+
+            /**
+             * @brief Same as `processSample(U)` with every level modulated by an external LFO (see `giml::ModBus`)
+             * @param in input
+             * @param lfo modulation in `[-1, 1]`
+             */
+            U processSample(U in, U lfo) {
+                return this->process(in, [lfo](int) { return lfo; });
+            }
         };
 
+        /**
+         * @brief All of the parallel comb filters, stored structure-of-arrays.
+         * 
+         * Every comb takes the same input and writes once per sample, so the delay lines share one slab
+         * interleaved by time (`pDelayLines[t * numCombs + c]`) and one write index. Per-comb delay offsets, 
+         * feedback gains and LPF states sit in their own contiguous arrays, so each pass below runs across 
+         * all combs at once (gathered reads, then one contiguous write of the whole frame) and vectorizes.
+         * 
+         * @tparam U floating-point type
+         */
         template <typename U>
-        class CombFilter { //not necessarily a standalone effect in itself
+        class CombFilterBank { //not necessarily a standalone effect in itself
         private:
-            //const CircularBuffer<U>* pDelayLineX; //Const pointer to avoid changing the delay line, we only want to read from it
-            CircularBuffer<U> delayLineY;
-            U CombFeedbackGain, LPFFeedbackGain;
-            float delayIndex;
-            bool neg; //Boolean whether or not we want this comb filter to be on bottom
-            Biquad<U> LPF;
-            U last = 0.f;
-            
+            int numCombs = 0;
+            size_t lineLength = 0, writeIndex = 0;
+            U* pDelayLines = nullptr; //numCombs delay lines of lineLength samples, interleaved by time
+
+            //Per-comb parameters and state (all in one allocation, see `allocate()`)
+            U* pParams = nullptr;
+            U *delayIndex, *frac, //fractional delay and its interpolation weight
+                *CombFeedbackGain, *LPFFeedbackGain, *last,
+                *sign, //-1 for comb filters that are flipped to the bottom, 1 otherwise
+                *yn; //scratch for the delayed values of the current sample
+            size_t* pOffsets = nullptr; //readSample()'s two integer delays per comb, clamped to the line length
+            static const int numParams = 7;
+
+            void allocate(int numCombs, size_t lineLength) {
+                this->release();
+                this->numCombs = numCombs;
+                this->lineLength = lineLength;
+                this->writeIndex = 0;
+                this->pDelayLines = (U*)::calloc(numCombs * lineLength, sizeof(U));
+                this->pParams = (U*)::calloc(numCombs * numParams, sizeof(U));
+                this->pOffsets = (size_t*)::calloc(numCombs * 2, sizeof(size_t));
+                this->delayIndex = this->pParams;
+                this->frac = this->delayIndex + numCombs;
+                this->CombFeedbackGain = this->frac + numCombs;
+                this->LPFFeedbackGain = this->CombFeedbackGain + numCombs;
+                this->last = this->LPFFeedbackGain + numCombs;
+                this->sign = this->last + numCombs;
+                this->yn = this->sign + numCombs;
+            }
+
+            void release() {
+                ::free(this->pDelayLines);
+                ::free(this->pParams);
+                ::free(this->pOffsets);
+                this->pDelayLines = nullptr;
+                this->pParams = nullptr;
+                this->pOffsets = nullptr;
+            }
+
+            void copyFrom(const CombFilterBank<U>& c) {
+                this->allocate(c.numCombs, c.lineLength);
+                this->writeIndex = c.writeIndex;
+                if (c.numCombs > 0) {
+                    ::memcpy(this->pDelayLines, c.pDelayLines, c.numCombs * c.lineLength * sizeof(U));
+                    ::memcpy(this->pParams, c.pParams, c.numCombs * numParams * sizeof(U));
+                    ::memcpy(this->pOffsets, c.pOffsets, c.numCombs * 2 * sizeof(size_t));
+                }
+            }
 
         public:
             //Constructor
-            CombFilter() = delete;
-            CombFilter(int sampleRate, /*const CircularBuffer<U>* pDelayLineIn,*/ bool negateResponse = false, float delayIndex = 0, float combFeedbackGain = 0.f, float lpfFeedbackGain = 0.f) : /*pDelayLineX(pDelayLineIn),*/ neg(negateResponse), delayIndex(delayIndex), CombFeedbackGain(combFeedbackGain), LPFFeedbackGain(lpfFeedbackGain), LPF(sampleRate) {
-                this->delayLineY.allocate(sampleRate * 5);
-                this->LPF.setType(Biquad<U>::BiquadUseCase::LPF_1st);
+            CombFilterBank() {}
+            CombFilterBank(int sampleRate, int numCombs) {
+                this->allocate(numCombs, sampleRate * 5);
+                for (int i = 0; i < numCombs; i++) {
+                    this->sign[i] = (i % 2) ? -1 : 1; //Every other comb filter is flipped to the bottom
+                    this->setDelayIndex(i, 0);
+                }
             }
             //Copy constructor
-            CombFilter(const CombFilter<U>& c) {
-                //this->pDelayLineX = c.pDelayLineX;
-                this->delayLineY = c.delayLineY;
-                this->delayIndex = c.delayIndex;
-                this->CombFeedbackGain = c.CombFeedbackGain;
-                this->LPFFeedbackGain = c.LPFFeedbackGain;
-                this->neg = c.neg;
-                this->LPF = c.LPF;
+            CombFilterBank(const CombFilterBank<U>& c) {
+                this->copyFrom(c);
             }
             //Copy assignment operator
-            CombFilter<U>& operator=(const CombFilter<U>& c) {
-                //this->pDelayLineX = c.pDelayLineX;
-                this->delayLineY = c.delayLineY;
-                this->delayIndex = c.delayIndex;
-                this->CombFeedbackGain = c.CombFeedbackGain;
-                this->LPFFeedbackGain = c.LPFFeedbackGain;
-                this->neg = c.neg;
-                this->LPF = c.LPF;
-
+            CombFilterBank<U>& operator=(const CombFilterBank<U>& c) {
+                if (this != &c) {
+                    this->copyFrom(c);
+                }
                 return *this;
             }
+            ~CombFilterBank() {
+                this->release();
+            }
 
-            void setDelayIndex(float delayIndex) {
-                this->delayIndex = delayIndex;
+            int size() const {
+                return this->numCombs;
             }
 
-            float getDelayIndex() const {
-                return this->delayIndex;
+            /**
+             * @brief Sets comb `i`'s (fractional) delay and precomputes the integer offsets 
+             * and interpolation weight that `CircularBuffer::readSample(float)` would use
+             */
+            void setDelayIndex(int i, float delayIndex) {
+                this->delayIndex[i] = delayIndex;
+                size_t readIndex = delayIndex; // sample 1
+                this->frac[i] = delayIndex - readIndex; // proportion of sample 2 to blend in
+                this->pOffsets[2 * i] = (readIndex >= this->lineLength) ? this->lineLength - 1 : readIndex; // limit delay to maxIndex
+                this->pOffsets[2 * i + 1] = (readIndex + 1 >= this->lineLength) ? this->lineLength - 1 : readIndex + 1;
             }
 
-            void setCombFeedbackGain(U g) {
-                this->CombFeedbackGain = g;
+            float getDelayIndex(int i) const {
+                return this->delayIndex[i];
             }
 
-            U getCombFeedbackGain() const {
-                return this->CombFeedbackGain;
+            void setCombFeedbackGain(int i, U g) {
+                this->CombFeedbackGain[i] = g;
             }
 
-            void setLPFFeedbackGain(U g) {
-                this->LPFFeedbackGain = g;
+            U getCombFeedbackGain(int i) const {
+                return this->CombFeedbackGain[i];
             }
 
-            U getLPFFeedbackGain() {
-                return this->LPFFeedbackGain;
+            void setLPFFeedbackGain(int i, U g) {
+                this->LPFFeedbackGain[i] = g;
             }
 
-            // void setLPFCutoffFrequency(float freq) {
-            //     this->LPF.setParams(freq);
-            // }
+            U getLPFFeedbackGain(int i) const {
+                return this->LPFFeedbackGain[i];
+            }
 
-            U processSample(U in) {
-                //Copied from block diagram
+            /**
+             * @brief Writes `numSamples` frames of zeros, see `CircularBuffer::writeSilence()`
+             */
+            void writeSilence(size_t numSamples) {
+                size_t toClear = (numSamples < this->lineLength) ? numSamples : this->lineLength;
+                size_t first = this->lineLength - this->writeIndex;
+                first = (toClear < first) ? toClear : first;
+                ::memset(this->pDelayLines + this->writeIndex * this->numCombs, 0, first * this->numCombs * sizeof(U));
+                ::memset(this->pDelayLines, 0, (toClear - first) * this->numCombs * sizeof(U));
+                this->writeIndex = (this->writeIndex + numSamples) % this->lineLength;
+            }
 
-                float yn = this->delayLineY.readSample(delayIndex);
-                 if (this->neg) {
-                    yn = -yn;
+            /**
+             * @brief Runs every comb filter on the same input sample
+             * @param in input sample
+             * @return the sum of all comb filter outputs
+             */
+            U processSample(U in) {
+                //Pass 1: gathered, interpolated reads from every delay line
+                for (int i = 0; i < this->numCombs; i++) {
+                    long int readIndex = this->writeIndex - this->pOffsets[2 * i];
+                    long int readIndex2 = this->writeIndex - this->pOffsets[2 * i + 1];
+                    readIndex += (readIndex < 0) ? this->lineLength : 0; // circular logic
+                    readIndex2 += (readIndex2 < 0) ? this->lineLength : 0;
+                    this->yn[i] = this->sign[i] * ( // do linear interpolation
+                        (this->pDelayLines[readIndex * this->numCombs + i] * (1.f - this->frac[i]))
+                        + (this->pDelayLines[readIndex2 * this->numCombs + i] * this->frac[i]));
                 }
-                //float FB = CombFeedbackGain * LPF.processSample(yn);
-                float filtered = yn + last * this->LPFFeedbackGain;
-                last = filtered;
-                float FB = filtered * this->CombFeedbackGain;
-                this->delayLineY.writeSample(in + FB);
-                return yn;
 
+                //Pass 2: LPF in the feedback loop and one contiguous write of the whole frame
+                U* frame = this->pDelayLines + this->writeIndex * this->numCombs;
+                U summedValue = 0;
+                for (int i = 0; i < this->numCombs; i++) {
+                    U filtered = giml::undenormalize(this->yn[i] + this->last[i] * this->LPFFeedbackGain[i]);
+                    this->last[i] = filtered;
+                    frame[i] = in + filtered * this->CombFeedbackGain[i];
+                    summedValue += this->yn[i];
+                }
 
-                // x[n-D] - g2 x[n-D-1] + g2 y[n-1] + g1 y[n-D]  (g2 = LPF gain)
-                // x[n-D] + g2 (y[n-1] - x[n-(D+1)]) + g1 y[n-D]
-
-                //U returnVal = this->pDelayLineX->readSample(delayIndex) // x[n-D]
-                //    + LPFFeedbackGain * (this->delayLineY.readSample(1) - this->pDelayLineX->readSample(delayIndex+1)) // g2 (y[n-1] - x[n-(D+1)])
-                //    + CombFeedbackGain * this->delayLineY.readSample(delayIndex); // g1 y[n-D]
-                //if (this->neg) {
-                //    returnVal = -returnVal;
-                //}
-                //this->delayLineY.writeSample(returnVal);
-                //return returnVal;
+                this->writeIndex++;
+                if (this->writeIndex >= this->lineLength) {
+                    this->writeIndex = 0; // circular logic 
+                }
+                return summedValue;
             }
-
         };
 
     };
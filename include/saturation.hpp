@@ -7,34 +7,45 @@ namespace giml {
     template <typename T>
     class Saturation : public Effect<T> {
     private:
-        float drive = 1.f, preAmpGain = 1.f, volume = 1.f;
+        //linear gains, ramp to new values in constant dB steps (see `setSmoothingTime()`)
+        giml::SmoothedValue<T> drive{1, SmoothingType::MULTIPLICATIVE}, preAmpGain{1, SmoothingType::MULTIPLICATIVE},
+            volume{1, SmoothingType::MULTIPLICATIVE};
         int sampleRate, oversamplingFactor;
         Biquad<T> antiAliasingFilter;
         T prevX = 0;
+        T* pOversampled = nullptr; // oversamplingFactor scratch samples, allocated once so `processSample()` never allocates
 
     public:
         Saturation(int sampleRate, int oversamplingFactor = 1) : sampleRate(sampleRate), oversamplingFactor(oversamplingFactor), antiAliasingFilter(Biquad<T>{sampleRate})  {
             this->antiAliasingFilter.setType(Biquad<T>::BiquadUseCase::LPF_2nd);
             this->antiAliasingFilter.setParams(this->sampleRate * oversamplingFactor / 2); //TODO: Verify this cutoff frequency
+            this->setSmoothingTime(20.f);
+            this->pOversampled = (T*)::calloc(this->oversamplingFactor, sizeof(T));
+        }
+        ~Saturation() {
+            ::free(this->pOversampled);
         }
-        ~Saturation() {}
         //Copy constructor
-        Saturation(const Saturation& s) {
+        Saturation(const Saturation& s) : antiAliasingFilter(s.antiAliasingFilter) {
             this->sampleRate = s.sampleRate;
             this->oversamplingFactor = s.oversamplingFactor;
             this->drive = s.drive;
+            this->preAmpGain = s.preAmpGain;
             this->volume = s.volume;
-            this->antiAliasingFilter = s.antiAliasingFilter;
             this->prevX = s.prevX;
+            this->pOversampled = (T*)::calloc(this->oversamplingFactor, sizeof(T));
         }
         //Copy assignment constructor
         Saturation& operator=(const Saturation& s) {
             this->sampleRate = s.sampleRate;
             this->oversamplingFactor = s.oversamplingFactor;
             this->drive = s.drive;
+            this->preAmpGain = s.preAmpGain;
             this->volume = s.volume;
             this->antiAliasingFilter = s.antiAliasingFilter;
             this->prevX = s.prevX;
+            ::free(this->pOversampled);
+            this->pOversampled = (T*)::calloc(this->oversamplingFactor, sizeof(T));
             
             return *this;
         }
@@ -43,6 +54,66 @@ namespace giml {
             if (!(this->enabled)) {
                 return in;
             }
+            T g = this->preAmpGain.next(), d = this->drive.next(), v = this->volume.next();
+            return this->process(in, g, d, v);
+        }
+
+        /**
+         * @brief Process a block of samples
+         * @param in input samples
+         * @param out output samples (may be the same as `in`)
+         * @param numSamples number of samples
+         */
+        void processBlock(const T* in, T* out, int numSamples) {
+            if (!(this->enabled)) {
+                ::memmove(out, in, numSamples * sizeof(T));
+                return;
+            }
+            T gainBlock[SmoothedValue<T>::maxBlock], driveBlock[SmoothedValue<T>::maxBlock],
+                volumeBlock[SmoothedValue<T>::maxBlock];
+            SmoothedValue<T>::forEachChunk(numSamples, [&](int start, int n) {
+                this->preAmpGain.fillBlock(gainBlock, n);
+                this->drive.fillBlock(driveBlock, n);
+                this->volume.fillBlock(volumeBlock, n);
+                for (int i = 0; i < n; i++) {
+                    out[start + i] = this->process(in[start + i], gainBlock[i], driveBlock[i], volumeBlock[i]);
+                }
+            });
+        }
+
+        void setVolume(float v) {
+            this->volume.setTarget(dBtoA(v));
+        }
+
+        void setDrive (float d) {
+            if (d <= 0.f) {
+                d += 1e-6;
+                printf("Drive set to pseudo-zero value, supply a positive float\n");
+            }
+            this->drive.setTarget(dBtoA(d));
+        }
+
+        void setPreAmpGain(float g) {
+            if (g == 0) {
+                g += 1e-6;
+            }
+            this->preAmpGain.setTarget(dBtoA(g));
+        }
+
+        /**
+         * @brief Sets the ramp time of volume, drive and pre-amp gain (see `giml::SmoothedValue::setRampTime()`)
+         */
+        void setSmoothingTime(float rampMillis) {
+            this->preAmpGain.setRampTime(rampMillis, this->sampleRate);
+            this->drive.setRampTime(rampMillis, this->sampleRate);
+            this->volume.setRampTime(rampMillis, this->sampleRate);
+        }
+
+    private:
+        /**
+         * @brief One sample of `processSample()` with this sample's (smoothed) gains
+         */
+        inline T process(T in, T preAmp, T driveGain, T vol) {
 
             // waveshaping functions
             //T x = in;
@@ -75,7 +146,7 @@ namespace giml {
             // }
             */
             
-            in *= this->preAmpGain;
+            in *= preAmp;
             
             T returnVal;
             if (this->oversamplingFactor > 1) {
@@ -88,7 +159,7 @@ namespace giml {
                 4. decimate and return
                 */
 
-                T* arrValues = (T*) ::malloc(this->oversamplingFactor * sizeof(T));
+                T* arrValues = this->pOversampled;
                 //arrValues[this->oversamplingFactor - 1] = in; //Set last value in array to current input
 
                 T delta = (in - prevX) / this->oversamplingFactor;
@@ -98,14 +169,14 @@ namespace giml {
                 for (int i = 0; i < this->oversamplingFactor; i++) {
                     arrValues[i] = in + i * delta; //Linear interpolation for each sample (1st is previous real sample and last is current input)
                     //TODO: Apply correct distortion function here for each sample
-                    //arrValues[i] = ::tanhf(this->drive * arrValues[i]) / ::tanhf(this->drive);
+                    //arrValues[i] = ::tanhf(driveGain * arrValues[i]) / ::tanhf(driveGain);
 
                     // asymmetrical distortion with 
                     if (arrValues[i] >= 0) { // if x positive 
-                        arrValues[i] = tanhf(this->drive * arrValues[i]) / tanhf(this->drive);
+                        arrValues[i] = tanhf(driveGain * arrValues[i]) / tanhf(driveGain);
                     }
                     else { // if x negative 
-                        arrValues[i] = tanhf(3*this->drive * arrValues[i]) / tanhf(3*this->drive);
+                        arrValues[i] = tanhf(3*driveGain * arrValues[i]) / tanhf(3*driveGain);
                     }
 
 
@@ -122,14 +193,14 @@ namespace giml {
             }
             else {
                 // symmetrical distortion with tanh
-                // returnVal = ::tanhf(this->drive * in) / ::tanhf(this->drive);
+                // returnVal = ::tanhf(driveGain * in) / ::tanhf(driveGain);
 
                 // asymmetrical distortion with 
                  if (in >= 0) { // if x positive 
-                     returnVal = ::tanhf(this->drive * in) / ::tanhf(this->drive);
+                     returnVal = ::tanhf(driveGain * in) / ::tanhf(driveGain);
                  }
                  else { // if y negative 
-                     returnVal = ::tanhf(3*this->drive * in) / ::tanhf(3*this->drive);
+                     returnVal = ::tanhf(3*driveGain * in) / ::tanhf(3*driveGain);
                  }
 
                 // oversampling ?
@@ -137,26 +208,7 @@ namespace giml {
             
             
             prevX = in;
-            return returnVal * this->volume;
-        }
-
-        void setVolume(float v) {
-            this->volume = dBtoA(v);
-        }
-
-        void setDrive (float d) {
-            if (d <= 0.f) {
-                d += 1e-6;
-                printf("Drive set to pseudo-zero value, supply a positive float/n");
-            }
-            this->drive = dBtoA(d);
-        }
-
-        void setPreAmpGain(float g) {
-            if (g == 0) {
-                g += 1e-6;
-            }
-            this->preAmpGain = dBtoA(g);
+            return returnVal * vol;
         }
     };
 }
@@ -0,0 +1,246 @@
+#ifndef GIML_STFT_HPP
+#define GIML_STFT_HPP
+#include "utility.hpp"
+#include "fft.hpp"
+namespace giml {
+    enum class WindowType {RECTANGULAR, HANN, HAMMING, BLACKMAN};
+
+    /**
+     * @brief Fills `window` with a periodic window function (periodic windows overlap-add evenly at regular hops)
+     * @param type shape of the window
+     * @param window output, `size` values
+     * @param size window length
+     */
+    template <typename T>
+    inline void fillWindow(WindowType type, T* window, int size) {
+        for (int n = 0; n < size; n++) {
+            double phase = M_2PI * n / size;
+            switch (type) {
+            case WindowType::RECTANGULAR:
+                window[n] = 1;
+                break;
+            case WindowType::HANN:
+                window[n] = 0.5 - 0.5 * ::cos(phase);
+                break;
+            case WindowType::HAMMING:
+                window[n] = 0.54 - 0.46 * ::cos(phase);
+                break;
+            case WindowType::BLACKMAN:
+                window[n] = 0.42 - 0.5 * ::cos(phase) + 0.08 * ::cos(2 * phase);
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Short-Time Fourier Transform (STFT) engine for spectral effects and analyzers
+     *
+     * Every `hopSize` samples the last `frameSize` inputs are windowed and transformed with a real FFT, the
+     * spectrum is handed to `processFrame()`, then transformed back, windowed again and overlap-added into
+     * the output. The synthesis window is normalized so that the analysis and synthesis windows sum to 1
+     * at any hop size where every sample is covered by a nonzero part of some window, so leaving `processFrame()`
+     * alone passes the input through unchanged (delayed by `getLatency()` samples). Hann and Blackman windows are
+     * zero at their first sample, so their hop is kept below `frameSize`.
+     *
+     * Derive from this class and override `processFrame()` to build a spectral effect
+     *
+     * @tparam T floating-point type
+     */
+    template <typename T>
+    class STFT : public Effect<T> {
+    protected:
+        int frameSize, hopSize, numBins;
+        FFT<T> fft;
+
+        /**
+         * @brief Called once per hop with the spectrum of the latest frame, modify it in place
+         * @param re real parts, `numBins` values
+         * @param im imaginary parts, `numBins` values
+         * @param numBins `frameSize/2 + 1`
+         */
+        virtual void processFrame(T*, T*, int) {}
+
+    private:
+        T* pAnalysisWindow = nullptr;
+        T* pSynthesisWindow = nullptr;
+        T* pInput = nullptr; //Last frameSize inputs, stored twice so a frame never wraps
+        T* pOutput = nullptr; //Overlap-add accumulator, frameSize long
+        T* pFrame = nullptr; //frameSize scratch
+        T* pRe = nullptr;
+        T* pIm = nullptr;
+        int inputIndex = 0, outputIndex = 0, hopCounter = 0;
+        WindowType windowType;
+
+        void allocate() {
+            this->fft.prepare(this->frameSize);
+            this->frameSize = this->fft.getSize();
+            this->numBins = this->fft.getNumBins();
+            bool zeroEdge = (this->windowType == WindowType::HANN || this->windowType == WindowType::BLACKMAN);
+            this->hopSize = giml::clip<int>(this->hopSize, 1, zeroEdge ? this->frameSize - 1 : this->frameSize); //a zero window sample must be covered by another frame
+            this->pAnalysisWindow = (T*)::calloc(this->frameSize, sizeof(T));
+            this->pSynthesisWindow = (T*)::calloc(this->frameSize, sizeof(T));
+            this->pInput = (T*)::calloc(2 * this->frameSize, sizeof(T));
+            this->pOutput = (T*)::calloc(this->frameSize, sizeof(T));
+            this->pFrame = (T*)::calloc(this->frameSize, sizeof(T));
+            this->pRe = (T*)::calloc(this->numBins, sizeof(T));
+            this->pIm = (T*)::calloc(this->numBins, sizeof(T));
+
+            //Divide the synthesis window by the overlapping window products so every sample is reconstructed with gain 1
+            giml::fillWindow<T>(this->windowType, this->pAnalysisWindow, this->frameSize);
+            for (int n = 0; n < this->frameSize; n++) {
+                T overlap = 0;
+                for (int m = n % this->hopSize; m < this->frameSize; m += this->hopSize) {
+                    overlap += this->pAnalysisWindow[m] * this->pAnalysisWindow[m];
+                }
+                this->pSynthesisWindow[n] = (overlap > 0) ? this->pAnalysisWindow[n] / overlap : 0;
+            }
+        }
+
+        void release() {
+            ::free(this->pAnalysisWindow);
+            ::free(this->pSynthesisWindow);
+            ::free(this->pInput);
+            ::free(this->pOutput);
+            ::free(this->pFrame);
+            ::free(this->pRe);
+            ::free(this->pIm);
+            this->pAnalysisWindow = this->pSynthesisWindow = this->pInput = this->pOutput = this->pFrame = nullptr;
+            this->pRe = this->pIm = nullptr;
+        }
+
+        void copyFrom(const STFT<T>& s) {
+            this->release();
+            this->enabled = s.enabled;
+            this->frameSize = s.frameSize;
+            this->hopSize = s.hopSize;
+            this->windowType = s.windowType;
+            this->allocate();
+            ::memcpy(this->pInput, s.pInput, 2 * this->frameSize * sizeof(T));
+            ::memcpy(this->pOutput, s.pOutput, this->frameSize * sizeof(T));
+            this->inputIndex = s.inputIndex;
+            this->outputIndex = s.outputIndex;
+            this->hopCounter = s.hopCounter;
+        }
+
+        /**
+         * @brief Analysis, `processFrame()` and overlap-add synthesis of the latest frame
+         */
+        void processHop() {
+            const T* frame = this->pInput + this->inputIndex; //Oldest to newest
+            for (int n = 0; n < this->frameSize; n++) {
+                this->pFrame[n] = frame[n] * this->pAnalysisWindow[n];
+            }
+            this->fft.forwardReal(this->pFrame, this->pRe, this->pIm);
+            this->processFrame(this->pRe, this->pIm, this->numBins);
+            this->fft.inverseReal(this->pRe, this->pIm, this->pFrame);
+
+            //The frame's first sample lines up with the next output sample
+            int index = this->outputIndex;
+            for (int n = 0; n < this->frameSize; n++) {
+                this->pOutput[index] += this->pFrame[n] * this->pSynthesisWindow[n];
+                index++;
+                if (index >= this->frameSize) {
+                    index = 0; // circular logic
+                }
+            }
+        }
+
+    public:
+        //Constructor
+        /**
+         * @param frameSize FFT size in samples, rounded up to a power of 2
+         * @param hopSize samples between frames (`frameSize/4` is a good default for the Hann window), at most
+         * `frameSize - 1` for Hann and Blackman windows
+         * @param windowType analysis and synthesis window
+         */
+        STFT(int frameSize = 1024, int hopSize = 256, WindowType windowType = WindowType::HANN) :
+            frameSize(frameSize), hopSize(hopSize), windowType(windowType) {
+            this->allocate();
+        }
+        //Copy constructor
+        STFT(const STFT<T>& s) {
+            this->copyFrom(s);
+        }
+        //Copy assignment operator
+        STFT<T>& operator=(const STFT<T>& s) {
+            if (this != &s) {
+                this->copyFrom(s);
+            }
+            return *this;
+        }
+        //Destructor
+        virtual ~STFT() {
+            this->release();
+        }
+
+        int getFrameSize() const {
+            return this->frameSize;
+        }
+
+        int getHopSize() const {
+            return this->hopSize;
+        }
+
+        /**
+         * @brief Delay between an input sample and its reconstruction in the output
+         */
+        int getLatency() const {
+            return this->frameSize;
+        }
+
+        /**
+         * @brief Clears the input history and any pending output
+         */
+        void reset() {
+            ::memset(this->pInput, 0, 2 * this->frameSize * sizeof(T));
+            ::memset(this->pOutput, 0, this->frameSize * sizeof(T));
+            this->inputIndex = this->outputIndex = this->hopCounter = 0;
+        }
+
+        /**
+         * @brief Function to process one sound sample through the `STFT` at a time
+         *
+         * @param in floating-point type input
+         * @return T floating-point (float or double) output
+         */
+        T processSample(T in) {
+            if (!(this->enabled)) {
+                return in;
+            }
+
+            this->pInput[this->inputIndex] = in;
+            this->pInput[this->inputIndex + this->frameSize] = in;
+            this->inputIndex++;
+            if (this->inputIndex >= this->frameSize) {
+                this->inputIndex = 0; // circular logic
+            }
+
+            T out = this->pOutput[this->outputIndex];
+            this->pOutput[this->outputIndex] = 0;
+            this->outputIndex++;
+            if (this->outputIndex >= this->frameSize) {
+                this->outputIndex = 0; // circular logic
+            }
+
+            this->hopCounter++;
+            if (this->hopCounter >= this->hopSize) {
+                this->hopCounter = 0;
+                this->processHop();
+            }
+            return out;
+        }
+
+        /**
+         * @brief Process a block of samples
+         * @param in input samples
+         * @param out output samples (may be the same as `in`)
+         * @param numSamples number of samples
+         */
+        void processBlock(const T* in, T* out, int numSamples) {
+            for (int i = 0; i < numSamples; i++) {
+                out[i] = this->processSample(in[i]);
+            }
+        }
+    };
+}
+#endif
@@ -3,6 +3,7 @@
 #include <math.h>
 #include "utility.hpp"
 #include "oscillator.hpp"
+#include "modbus.hpp"
 namespace giml {
     /**
      * @brief This class implements a basic tremolo effect 
@@ -13,13 +14,16 @@ namespace giml {
     class Tremolo : public Effect<T> {
     private:
         int sampleRate;
-        float speed = 1000.f, depth = 1.f;
-        giml::SinOsc<T> osc;
+        float speed = 1000.f;
+        giml::SmoothedValue<T> depth{1}; // ramps to new values, see `setSmoothingTime()`
+        giml::QuadOsc<T> osc; // LFO, rotates instead of calling sin() every sample
+        giml::ModTap<T> modTap; // replaces `osc` when connected, see `setModSource()`
 
     public:
         Tremolo() = delete;
         Tremolo (int samprate) : sampleRate(samprate), osc(samprate) {
             this->osc.setFrequency(1000.f / this->speed);
+            this->setSmoothingTime(20.f);
         }
 
         /**
@@ -31,9 +35,33 @@ namespace giml {
             if (!(this->enabled)) {
                 return in;
             }
-            T gain = this->osc.processSample() * 0.5 + 0.5; // waveshape SinOsc output to make it unipolar
-            gain *= this->depth; // scale by depth
-            return in * (1 - gain); // return in * waveshaped SinOsc 
+            T lfo = this->modTap.isConnected() ? this->modTap.next() : this->osc.processSample();
+            T gain = lfo * 0.5 + 0.5; // waveshape osc output to make it unipolar
+            gain *= this->depth.next(); // scale by depth
+            return in * (1 - gain); // return in * waveshaped osc 
+        }
+
+        /**
+         * @brief Process a block of samples
+         * @param in input samples
+         * @param out output samples (may be the same as `in`)
+         * @param numSamples number of samples
+         */
+        void processBlock(const T* in, T* out, int numSamples) {
+            if (!(this->enabled)) {
+                ::memmove(out, in, numSamples * sizeof(T));
+                return;
+            }
+            T depthBlock[SmoothedValue<T>::maxBlock], lfoBlock[SmoothedValue<T>::maxBlock];
+            SmoothedValue<T>::forEachChunk(numSamples, [&](int start, int n) {
+                this->depth.fillBlock(depthBlock, n);
+                for (int i = 0; i < n; i++) {
+                    lfoBlock[i] = this->modTap.isConnected() ? this->modTap.next() : this->osc.processSample();
+                }
+                for (int i = 0; i < n; i++) { // vectorizes
+                    out[start + i] = in[start + i] * (1 - (lfoBlock[i] * T(0.5) + T(0.5)) * depthBlock[i]);
+                }
+            });
         }
 
         /**
@@ -46,14 +74,30 @@ namespace giml {
             this->osc.setFrequency(1000.f / this->speed); // convert to Hz (milliseconds to seconds)
         }
 
+        /**
+         * @brief Use a shared LFO from a `giml::ModBus` instead of `osc`
+         * @param bus bus to read from (`nullptr` goes back to `osc`)
+         * @param source index returned by `ModBus::addSource()`
+         */
+        void setModSource(const giml::ModBus<T>* bus, int source = 0) {
+            this->modTap.connect(bus, source);
+        }
+
         /**
          * @brief sets the amount of gain reduction when `osc` is at its peak
          * @param d modulation depth (clamped to [0,1])
          */
         void setDepth(float d) { // set depth
-            if ( d < 0.f ) { this->depth = 0.f; }
-            else if ( d > 1 ) { this->depth = 1.f; }
-            else { this->depth = d; }
+            if ( d < 0.f ) { d = 0.f; }
+            else if ( d > 1 ) { d = 1.f; }
+            this->depth.setTarget(d);
+        }
+
+        /**
+         * @brief Sets the ramp time of depth (see `giml::SmoothedValue::setRampTime()`)
+         */
+        void setSmoothingTime(float rampMillis) {
+            this->depth.setRampTime(rampMillis, this->sampleRate);
         }
     };
 }
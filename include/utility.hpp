@@ -55,6 +55,46 @@ namespace giml {
         return numSamples / (float)sampRate * 1000.f;
     }
 
+    /**
+     * @brief Note lengths for tempo-synced parameters
+     * (dotted notes are 1.5x as long, triplets 2/3 as long)
+     */
+    enum class NoteDivision {
+        WHOLE, HALF, QUARTER, EIGHTH, SIXTEENTH, THIRTY_SECOND,
+        DOTTED_HALF, DOTTED_QUARTER, DOTTED_EIGHTH, DOTTED_SIXTEENTH,
+        HALF_TRIPLET, QUARTER_TRIPLET, EIGHTH_TRIPLET, SIXTEENTH_TRIPLET
+    };
+
+    /**
+     * @brief Converts a note length at a given tempo to milliseconds
+     * @param division note length
+     * @param bpm tempo in quarter notes per minute
+     * @return length of one `division` in milliseconds
+     */
+    inline float noteDivisionToMillis(NoteDivision division, float bpm) {
+        float beats = 1.f; // in quarter notes
+        switch (division) {
+        case NoteDivision::WHOLE: beats = 4.f; break;
+        case NoteDivision::HALF: beats = 2.f; break;
+        case NoteDivision::QUARTER: beats = 1.f; break;
+        case NoteDivision::EIGHTH: beats = 0.5f; break;
+        case NoteDivision::SIXTEENTH: beats = 0.25f; break;
+        case NoteDivision::THIRTY_SECOND: beats = 0.125f; break;
+        case NoteDivision::DOTTED_HALF: beats = 3.f; break;
+        case NoteDivision::DOTTED_QUARTER: beats = 1.5f; break;
+        case NoteDivision::DOTTED_EIGHTH: beats = 0.75f; break;
+        case NoteDivision::DOTTED_SIXTEENTH: beats = 0.375f; break;
+        case NoteDivision::HALF_TRIPLET: beats = 4.f / 3.f; break;
+        case NoteDivision::QUARTER_TRIPLET: beats = 2.f / 3.f; break;
+        case NoteDivision::EIGHTH_TRIPLET: beats = 1.f / 3.f; break;
+        case NoteDivision::SIXTEENTH_TRIPLET: beats = 1.f / 6.f; break;
+        }
+        if (bpm <= 0) {
+            bpm = 120.f;
+        }
+        return beats * 60000.f / bpm;
+    }
+
     /**
      * @brief Mixes two numbers with linear interpolation
      * @param in1 input 1
@@ -121,6 +161,25 @@ namespace giml {
         return lin + nonLin;
     }
 
+    /**
+     * @brief Portable denormal protection for feedback paths, for when `giml::ScopedFlushDenormals` can't be used
+     * (unsupported CPU, or a host that owns the floating-point settings).
+     *
+     * Adding and then subtracting a tiny offset (-360dB) rounds anything far below it to exactly 0, so a decaying
+     * feedback loop reaches silence instead of lingering in slow subnormal numbers. Louder values come back within
+     * 1e-18. Only active when `GIML_DENORMAL_FALLBACK` is defined, otherwise `x` is returned untouched
+     * @param x feedback value about to be stored
+     * @return `x`, with values below ~1e-25 flushed to 0
+     */
+    template <typename T>
+    inline T undenormalize(T x) {
+#ifdef GIML_DENORMAL_FALLBACK
+        x += static_cast<T>(1e-18);
+        x -= static_cast<T>(1e-18);
+#endif
+        return x;
+    }
+
     /**
      * @brief calculates the number of samples a given decay multiplier 
      * will need to decay by -60dB.
@@ -158,6 +217,90 @@ namespace giml {
       return gVal;
     }
 
+    /**
+     * @brief `constexpr` sine for compile-time coefficient design.
+     * Wraps `x` to `[-pi, pi]` and sums the Taylor series until it converges.
+     * Use `::sinf`/`::sin` at runtime, this is only meant for constant expressions (requires C++14)
+     * @param x angle in radians
+     * @return `sin(x)`
+     */
+    constexpr double constexprSin(double x) {
+        long long k = static_cast<long long>(x / M_2PI + (x >= 0 ? 0.5 : -0.5));
+        x -= k * M_2PI; // wrap to [-pi, pi]
+        double term = x, sum = x;
+        for (int n = 1; n < 20; n++) {
+            term *= -x * x / ((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    /**
+     * @brief `constexpr` cosine, see `giml::constexprSin()`
+     * @param x angle in radians
+     * @return `cos(x)`
+     */
+    constexpr double constexprCos(double x) {
+        return giml::constexprSin(x + M_PI_2);
+    }
+
+    /**
+     * @brief `constexpr` tangent, see `giml::constexprSin()`
+     * @param x angle in radians
+     * @return `tan(x)`
+     */
+    constexpr double constexprTan(double x) {
+        return giml::constexprSin(x) / giml::constexprCos(x);
+    }
+
+    /**
+     * @brief `constexpr` square root using Newton's method
+     * @param x non-negative input
+     * @return `sqrt(x)`
+     */
+    constexpr double constexprSqrt(double x) {
+        if (x <= 0) {return 0;}
+        double guess = (x > 1) ? x : 1;
+        for (int i = 0; i < 100; i++) {
+            double next = 0.5 * (guess + x / guess);
+            if (next == guess) {break;}
+            guess = next;
+        }
+        return guess;
+    }
+
+    /**
+     * @brief `constexpr` exponential. Halves `x` until the Taylor series converges quickly,
+     * then squares the result back up
+     * @param x exponent
+     * @return `e^x`
+     */
+    constexpr double constexprExp(double x) {
+        int halvings = 0;
+        while (x > 0.5 || x < -0.5) {
+            x /= 2;
+            halvings++;
+        }
+        double term = 1, sum = 1;
+        for (int n = 1; n < 20; n++) {
+            term *= x / n;
+            sum += term;
+        }
+        for (int i = 0; i < halvings; i++) {
+            sum *= sum;
+        }
+        return sum;
+    }
+
+    /**
+     * @brief `constexpr` version of `giml::dBtoA()`
+     * @param dBVal input value in dB
+     * @return input value in amplitude
+     */
+    constexpr double constexprDBtoA(double dBVal) {
+        return giml::constexprExp(dBVal / 20.0 * 2.302585092994046); // 10^(dB/20) = e^(ln(10) * dB/20)
+    }
+
     /**
      * @brief Effect class that implements a bypass switch (enabled by default)
      */
@@ -182,6 +325,15 @@ namespace giml {
             return in;
         }
 
+        /**
+         * @brief How long the effect keeps producing output after its input goes silent, e.g. for a host
+         * deciding when it can stop processing a track
+         * @return tail length in seconds (0 for effects without memory, `INFINITY` if it never decays)
+         */
+        virtual float getTailLength() {
+            return 0.f;
+        }
+
     protected:
         bool enabled = false;
     };
@@ -217,6 +369,280 @@ namespace giml {
         }
     };
 
+    /**
+     * @brief Use this enum type to choose the shape of a `giml::SmoothedValue` ramp
+     */
+    enum class SmoothingType {
+        LINEAR, // constant step per sample (mixes, depths)
+        EXPONENTIAL, // one-pole toward the target, fast then slow (like an analog control)
+        MULTIPLICATIVE // constant ratio per sample, linear in dB/octaves (gains, frequencies). Needs nonzero values of the same sign
+    };
+
+    /**
+     * @brief A parameter that ramps to its target over a fixed time instead of jumping, so automation doesn't
+     * cause zipper noise.
+     *
+     * Setters only call `setTarget()` (any expensive conversion like `dBtoA()` happens once there), and the
+     * effect reads one value per sample with `next()` or a whole block with `fillBlock()`. Every ramp lasts
+     * exactly `rampSamples` samples and then lands on the target, so a settled value is exactly the target.
+     * Until the first value is read, `setTarget()` jumps instead of ramping, so parameters set between
+     * constructing an effect and processing its first sample apply from that first sample.
+     *
+     * Effects smooth a host block `maxBlock` samples at a time (see `forEachChunk()`): each parameter is filled
+     * into a `T[maxBlock]` array on the stack and then read by a per-sample loop. That keeps the arrays small
+     * and in cache whatever block size the host uses, while each chunk is still long enough for `fillBlock()`
+     * to vectorize
+     */
+    template <typename T>
+    class SmoothedValue {
+    public:
+        static const int maxBlock = 64; // most samples `fillBlock()` is asked for at once by the effects
+
+    private:
+        SmoothingType type, rampType; // rampType is `type` unless a MULTIPLICATIVE ramp had to fall back to LINEAR
+        T current = 0, target = 0;
+        T step = 0; // increment (LINEAR) or multiplier (EXPONENTIAL, MULTIPLICATIVE) per sample
+        int rampSamples = 0, countdown = 0;
+        bool started = false; // set once a value has been read, see `setTarget()`
+
+    public:
+        /**
+         * @param initial starting value
+         * @param type shape of the ramps
+         */
+        SmoothedValue(T initial = 0, SmoothingType type = SmoothingType::LINEAR) : type(type), rampType(type), current(initial), target(initial) {}
+
+        /**
+         * @brief Sets how long a ramp takes. A ramp in progress finishes with its old timing.
+         * Effects expose this as `setSmoothingTime()` for all of their smoothed parameters at once
+         * @param rampMillis ramp time in milliseconds (0 for immediate changes)
+         * @param sampleRate sample rate of your project
+         */
+        void setRampTime(float rampMillis, int sampleRate) {
+            this->rampSamples = (int)giml::millisToSamples(rampMillis, sampleRate);
+            this->rampSamples = (this->rampSamples < 0) ? 0 : this->rampSamples;
+        }
+
+        void setType(SmoothingType t) {
+            this->type = t;
+        }
+
+        /**
+         * @brief Starts a ramp from the current value to `newTarget` (or jumps to it if no value has been read yet)
+         * @param newTarget value to reach after the ramp time
+         */
+        void setTarget(T newTarget) {
+            this->target = newTarget;
+            if (this->rampSamples <= 0 || this->current == newTarget || !this->started) {
+                this->current = newTarget;
+                this->countdown = 0;
+                return;
+            }
+            this->countdown = this->rampSamples;
+            this->rampType = this->type;
+            switch (this->rampType) {
+            case SmoothingType::EXPONENTIAL:
+                this->step = ::pow(1e-3, 1.0 / this->rampSamples); // within 0.1% when the ramp ends
+                break;
+            case SmoothingType::MULTIPLICATIVE:
+                if (this->current * newTarget > 0) {
+                    this->step = ::pow(newTarget / this->current, 1.0 / this->rampSamples);
+                    break;
+                }
+                this->rampType = SmoothingType::LINEAR; // can't ramp through zero multiplicatively
+                // fall through
+            case SmoothingType::LINEAR:
+                this->step = (newTarget - this->current) / this->rampSamples;
+                break;
+            }
+        }
+
+        /**
+         * @brief Jumps straight to a value, cancelling any ramp
+         * @param v new current and target value
+         */
+        void setCurrentAndTarget(T v) {
+            this->current = this->target = v;
+            this->countdown = 0;
+        }
+
+        T getTarget() const {
+            return this->target;
+        }
+
+        T getCurrent() const {
+            return this->current;
+        }
+
+        bool isSmoothing() const {
+            return this->countdown > 0;
+        }
+
+        /**
+         * @brief Advances one sample
+         * @return the smoothed value
+         */
+        inline T next() {
+            this->started = true;
+            if (this->countdown > 0) {
+                switch (this->rampType) {
+                case SmoothingType::LINEAR:
+                    this->current += this->step;
+                    break;
+                case SmoothingType::EXPONENTIAL:
+                    this->current = this->target + (this->current - this->target) * this->step;
+                    break;
+                case SmoothingType::MULTIPLICATIVE:
+                    this->current *= this->step;
+                    break;
+                }
+                if (--this->countdown == 0) {
+                    this->current = this->target;
+                }
+            }
+            return this->current;
+        }
+
+        /**
+         * @brief Advances `numSamples` samples, writing every value (the same values as calling `next()` in a loop,
+         * up to rounding).
+         * Once the ramp is done the rest of the block is a plain fill
+         * @param out output values
+         * @param numSamples number of samples
+         */
+        void fillBlock(T* out, int numSamples) {
+            this->started = true;
+            int ramp = (this->countdown < numSamples) ? this->countdown : numSamples;
+            if (ramp > 0) {
+                int last = ramp - 1;
+                if (this->rampType == SmoothingType::LINEAR) {
+                    T start = this->current, increment = this->step;
+                    for (int i = 0; i < ramp; i++) {
+                        out[i] = start + (i + 1) * increment; // closed form, vectorizes
+                    }
+                } else {
+                    for (int i = 0; i < ramp; i++) {
+                        out[i] = this->next();
+                    }
+                }
+                this->countdown -= (this->rampType == SmoothingType::LINEAR) ? ramp : 0;
+                if (this->countdown == 0) {
+                    out[last] = this->target;
+                }
+                this->current = out[last];
+            }
+            for (int i = ramp; i < numSamples; i++) {
+                out[i] = this->current;
+            }
+        }
+
+        /**
+         * @brief Advances `numSamples` samples without writing them
+         * @param numSamples number of samples
+         */
+        void skip(int numSamples) {
+            this->started = true;
+            if (this->countdown <= numSamples || this->rampType != SmoothingType::LINEAR) {
+                for (int i = 0; i < numSamples && this->countdown > 0; i++) {
+                    this->next();
+                }
+                return;
+            }
+            this->current += numSamples * this->step;
+            this->countdown -= numSamples;
+        }
+
+        /**
+         * @brief Splits a block into chunks of at most `maxBlock` samples
+         * @param numSamples number of samples in the block
+         * @param process called as `process(start, n)` for each chunk, in order
+         */
+        template <typename F>
+        static void forEachChunk(int numSamples, F&& process) {
+            for (int start = 0; start < numSamples; start += maxBlock) {
+                process(start, (numSamples - start < maxBlock) ? numSamples - start : maxBlock);
+            }
+        }
+    };
+
+    /**
+     * @brief Lets an effect with a tail (delay, reverb) stop processing while it has nothing to do.
+     *
+     * The effect reports whether each block's input and output were silent (every sample below the threshold)
+     * with `update()`. Once they have been silent for longer than the effect's tail, its internal state has decayed
+     * away and the detector is idle: the effect can pass silent input straight through instead of running its
+     * delay lines and LFOs on zeros. The first input sample above the threshold wakes it again, so nothing is missed
+     */
+    template <typename T>
+    class SilenceDetector {
+    private:
+        bool active = false;
+        T threshold = 3.1622776e-5; // -90dB
+        int holdSamples = 0; // silence needed before idling, the effect's tail in samples
+        int silentSamples = 0;
+
+    public:
+        /**
+         * @brief Turns idle detection on or off (off by default, the effect then always processes)
+         * @param on whether the effect may idle
+         * @param thresholdDB level below which a sample counts as silent
+         */
+        void setActive(bool on, float thresholdDB = -90.f) {
+            this->active = on;
+            this->threshold = giml::dBtoA(thresholdDB);
+            this->silentSamples = 0;
+        }
+
+        bool isActive() const {
+            return this->active;
+        }
+
+        /**
+         * @brief Sets how long input and output must stay silent before idling
+         * @param samples the effect's tail length in samples (`INFINITY` never idles)
+         */
+        void setHoldSamples(double samples) {
+            this->holdSamples = (samples < 2147483647.0) ? static_cast<int>(::ceil(samples)) : 2147483647;
+        }
+
+        bool isIdle() const {
+            return this->active && this->silentSamples >= this->holdSamples;
+        }
+
+        bool isSilent(T x) const {
+            return ::fabs(x) < this->threshold;
+        }
+
+        /**
+         * @return whether every sample in `x` is below the threshold
+         */
+        bool isSilent(const T* x, int numSamples) const {
+            T peak = 0;
+            for (int i = 0; i < numSamples; i++) { // vectorizes
+                T a = ::fabs(x[i]);
+                peak = (a > peak) ? a : peak;
+            }
+            return peak < this->threshold;
+        }
+
+        /**
+         * @brief Counts silence after the effect processed some samples
+         * @param silent whether the input and output were both silent
+         * @param numSamples number of samples processed
+         */
+        void update(bool silent, int numSamples) {
+            if (!silent) {
+                this->silentSamples = 0;
+            }
+            else if (numSamples < this->holdSamples - this->silentSamples) {
+                this->silentSamples += numSamples;
+            }
+            else {
+                this->silentSamples = this->holdSamples;
+            }
+        }
+    };
+
     /**
      * @brief Circular buffer implementation. 
      * Handy for effects that require a delay line.
@@ -290,6 +716,20 @@ namespace giml {
             }
         }
 
+        /**
+         * @brief Writes `numSamples` zeros, the same as `writeSample(0)` that many times
+         * (effects call this while idling, so that older audio can't be read again later)
+         * @param numSamples number of samples
+         */
+        void writeSilence(size_t numSamples) {
+            size_t toClear = (numSamples < this->bufferSize) ? numSamples : this->bufferSize;
+            size_t first = this->bufferSize - this->writeIndex; // up to the end of the array, then wrap around
+            first = (toClear < first) ? toClear : first;
+            ::memset(this->pBackingArr + this->writeIndex, 0, first * sizeof(T));
+            ::memset(this->pBackingArr, 0, (toClear - first) * sizeof(T));
+            this->writeIndex = (this->writeIndex + numSamples) % this->bufferSize;
+        }
+
         /**
          * @brief Reads a sample from the buffer
          * @param delayInSamples access a sample this many samples ago
@@ -0,0 +1,195 @@
+#ifndef GIML_WAVETABLEOSC_HPP
+#define GIML_WAVETABLEOSC_HPP
+#include "utility.hpp"
+#include "fft.hpp"
+#include "oscillator.hpp"
+namespace giml {
+    /**
+     * @brief Band-limited Wavetable Oscillator that inherits from `giml::Phasor`
+     *
+     * Each waveform is stored as a set of single-cycle tables, one per octave: the table for an octave only has the
+     * harmonics that stay below Nyquist for every frequency in that octave, so nothing aliases when sonified.
+     * Tables are built once from the waveform's harmonics with an inverse FFT and read with linear interpolation,
+     * which is cheaper than calling `::sin` every sample
+     */
+    template <typename T>
+    class WavetableOsc : public Phasor<T> {
+    public:
+        enum class Waveform {SINE, SAW, SQUARE, TRIANGLE, CUSTOM};
+
+    private:
+        static const int tableSize = 2048;
+        static const int numLevels = 11; //level k has at most tableSize/2 >> k harmonics (1024 down to 1)
+
+        Waveform waveform = Waveform::SINE;
+        T* pTables = nullptr; //numLevels tables of tableSize + 1 samples (with a guard point)
+        const T* pCurrentTable = nullptr;
+
+        /**
+         * @brief Picks the table with the most harmonics that all stay below Nyquist at the current frequency
+         */
+        void selectTable() {
+            T harmonicsAllowed = (this->frequency != 0) ? (this->sampleRate / 2) / ::abs(this->frequency) : tableSize / 2;
+            int level = 0;
+            while (level < numLevels - 1 && (tableSize / 2 >> level) > harmonicsAllowed) {
+                level++;
+            }
+            this->pCurrentTable = this->pTables + level * (tableSize + 1);
+        }
+
+        /**
+         * @brief Builds every level from a spectrum (`tableSize/2 + 1` bins, as from `giml::FFT::forwardReal()`)
+         */
+        void buildTables(const T* spectrumRe, const T* spectrumIm) {
+            FFT<T> fft(tableSize);
+            T* re = (T*)::calloc(tableSize / 2 + 1, sizeof(T));
+            T* im = (T*)::calloc(tableSize / 2 + 1, sizeof(T));
+            for (int level = 0; level < numLevels; level++) {
+                int maxHarmonic = tableSize / 2 >> level;
+                for (int k = 0; k <= tableSize / 2; k++) {
+                    re[k] = (k <= maxHarmonic) ? spectrumRe[k] : 0;
+                    im[k] = (k <= maxHarmonic) ? spectrumIm[k] : 0;
+                }
+                if (maxHarmonic == tableSize / 2) {
+                    im[tableSize / 2] = 0;
+                }
+                T* table = this->pTables + level * (tableSize + 1);
+                fft.inverseReal(re, im, table);
+                table[tableSize] = table[0]; // guard point
+            }
+            ::free(re);
+            ::free(im);
+            this->selectTable();
+        }
+
+    public:
+        /**
+         * @param sampRate sample rate of your project
+         * @param wave initial waveform
+         */
+        WavetableOsc(int sampRate, Waveform wave = Waveform::SINE) : Phasor<T>(sampRate) {
+            this->pTables = (T*)::calloc(numLevels * (tableSize + 1), sizeof(T));
+            this->setWaveform(wave);
+        }
+        // Copy constructor
+        WavetableOsc(const WavetableOsc<T>& w) : Phasor<T>(w) {
+            this->waveform = w.waveform;
+            this->pTables = (T*)::calloc(numLevels * (tableSize + 1), sizeof(T));
+            ::memcpy(this->pTables, w.pTables, numLevels * (tableSize + 1) * sizeof(T));
+            this->selectTable();
+        }
+        // Copy assignment constructor
+        WavetableOsc<T>& operator=(const WavetableOsc<T>& w) {
+            if (this != &w) {
+                Phasor<T>::operator=(w);
+                this->waveform = w.waveform;
+                ::memcpy(this->pTables, w.pTables, numLevels * (tableSize + 1) * sizeof(T));
+                this->selectTable();
+            }
+            return *this;
+        }
+        ~WavetableOsc() {
+            ::free(this->pTables);
+        }
+
+        void setSampleRate(int sampRate) override {
+            Phasor<T>::setSampleRate(sampRate);
+            this->selectTable();
+        }
+
+        void setFrequency(T freqHz) override {
+            Phasor<T>::setFrequency(freqHz);
+            this->selectTable();
+        }
+
+        /**
+         * @brief Builds the tables for one of the standard waveforms (allocates scratch, call outside the audio callback)
+         * @param wave `SINE`, `SAW`, `SQUARE` or `TRIANGLE` (`CUSTOM` is set with `setTable()`)
+         */
+        void setWaveform(Waveform wave) {
+            if (wave == Waveform::CUSTOM) {
+                printf("Use setTable() to set a custom waveform\n");
+                return;
+            }
+            this->waveform = wave;
+            // Sine partials: sum of b_n * sin(2pi n t) has DFT bin n = -i * (tableSize/2) * b_n
+            T* re = (T*)::calloc(tableSize / 2 + 1, sizeof(T));
+            T* im = (T*)::calloc(tableSize / 2 + 1, sizeof(T));
+            for (int n = 1; n <= tableSize / 2; n++) {
+                T b = 0;
+                switch (wave) {
+                case Waveform::SINE:
+                    b = (n == 1) ? 1 : 0;
+                    break;
+                case Waveform::SAW: // rising saw
+                    b = -2 / (M_PI * n) * ((n % 2) ? -1 : 1);
+                    break;
+                case Waveform::SQUARE:
+                    b = (n % 2) ? 4 / (M_PI * n) : 0;
+                    break;
+                case Waveform::TRIANGLE:
+                    b = (n % 2) ? 8 / (M_PI * M_PI * n * n) * (((n / 2) % 2) ? -1 : 1) : 0;
+                    break;
+                default:
+                    break;
+                }
+                im[n] = -b * tableSize / 2;
+            }
+            this->buildTables(re, im);
+            ::free(re);
+            ::free(im);
+        }
+
+        /**
+         * @brief Sets a custom single-cycle waveform and band-limits it (allocates scratch, call outside the audio callback)
+         * @param samples one cycle of the waveform
+         * @param length number of samples (resampled to the internal table size if different)
+         */
+        void setTable(const T* samples, int length) {
+            this->waveform = Waveform::CUSTOM;
+            T* cycle = (T*)::calloc(tableSize, sizeof(T));
+            for (int i = 0; i < tableSize; i++) {
+                T position = (T)i * length / tableSize;
+                int i1 = position;
+                T frac = position - i1;
+                cycle[i] = samples[i1 % length] * (1 - frac) + samples[(i1 + 1) % length] * frac;
+            }
+            FFT<T> fft(tableSize);
+            T* re = (T*)::calloc(tableSize / 2 + 1, sizeof(T));
+            T* im = (T*)::calloc(tableSize / 2 + 1, sizeof(T));
+            fft.forwardReal(cycle, re, im);
+            this->buildTables(re, im);
+            ::free(cycle);
+            ::free(re);
+            ::free(im);
+        }
+
+        Waveform getWaveform() const {
+            return this->waveform;
+        }
+
+        /**
+         * @brief Increments `phase` and returns the interpolated table value
+         * @return band-limited waveform (after increment)
+         */
+        T processSample() override {
+            T position = Phasor<T>::processSample() * tableSize;
+            int i = (int)position;
+            i = (i >= tableSize) ? tableSize - 1 : i;
+            T frac = position - i;
+            return this->pCurrentTable[i] + frac * (this->pCurrentTable[i + 1] - this->pCurrentTable[i]);
+        }
+
+        /**
+         * @brief Fills a block with consecutive samples
+         * @param out output samples
+         * @param numSamples number of samples
+         */
+        void process(T* out, int numSamples) {
+            for (int n = 0; n < numSamples; n++) {
+                out[n] = this->WavetableOsc<T>::processSample();
+            }
+        }
+    };
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+/**
+ * Checks that `giml::PitchShifter` moves a sine an octave down cleanly in both modes.
+ *
+ * The tones are chosen to fall between FFT bins, so each frame's peak has side lobes that are peaks of their own.
+ * Pitching down makes their regions overlap the main peak's, which used to smear the output into a weak tone
+ * several Hz off. Exits with 1 if the output isn't a sine at half the frequency with most of the input level.
+ *
+ *     g++ -std=c++14 -O2 -I include test/pitchshifter.cpp -o test_pitchshifter
+ */
+#include <cmath>
+#include <cstdio>
+#include "../include/pitchshifter.hpp"
+
+static const int sampleRate = 48000;
+static const int numSamples = sampleRate * 2;
+static const int window = 16384; // measured at the end of the output, after the shifter has settled
+
+/**
+ * @brief Amplitude of the component at `freq` in a Hann-windowed stretch of `x`
+ */
+static double amplitudeAt(const float* x, int n, double freq) {
+    double re = 0, im = 0;
+    for (int i = 0; i < n; i++) {
+        double w = 0.5 - 0.5 * ::cos(M_2PI * i / n);
+        re += w * x[i] * ::cos(M_2PI * freq * i / sampleRate);
+        im += w * x[i] * ::sin(M_2PI * freq * i / sampleRate);
+    }
+    return 4 * ::sqrt(re * re + im * im) / n; // 2/n for a one-sided spectrum, 2 for the Hann window's gain
+}
+
+/**
+ * @return whether an octave down of a sine at `freq` comes out as a sine at `freq / 2`
+ */
+static bool checkOctaveDown(giml::PitchShifter<float>::Mode mode, const char* modeName, double freq) {
+    giml::PitchShifter<float> shifter{ sampleRate, mode };
+    shifter.setPitchRatio(0.5f);
+    shifter.enable();
+
+    float* in = (float*)::calloc(numSamples, sizeof(float));
+    float* out = (float*)::calloc(numSamples, sizeof(float));
+    for (int i = 0; i < numSamples; i++) {
+        in[i] = 0.5f * ::sinf(M_2PI * freq * i / sampleRate);
+    }
+    shifter.processBlock(in, out, numSamples);
+
+    //The loudest frequency near the target, and how much of the output's power it accounts for
+    const float* tail = out + numSamples - window;
+    double peakFreq = 0, peakAmp = 0;
+    for (double f = freq / 2 - 50; f <= freq / 2 + 50; f += 0.5) {
+        double a = amplitudeAt(tail, window, f);
+        if (a > peakAmp) {
+            peakAmp = a;
+            peakFreq = f;
+        }
+    }
+    double power = 0;
+    for (int i = 0; i < window; i++) {
+        power += tail[i] * tail[i];
+    }
+    double purity = (peakAmp * peakAmp / 2) / (power / window);
+    ::free(in);
+    ::free(out);
+
+    bool pass = ::fabs(peakFreq - freq / 2) <= 1 && peakAmp > 0.35 && purity > 0.95;
+    printf("%-11s %7.1fHz -> %7.1fHz, amplitude %.3f, %.1f%% of the power  %s\n",
+        modeName, freq, peakFreq, peakAmp, 100 * purity, pass ? "ok" : "FAILED");
+    return pass;
+}
+
+int main() {
+    bool pass = true;
+    const double freqs[] = { 261.6, 440.0, 1000.0 };
+    for (double f : freqs) {
+        pass &= checkOctaveDown(giml::PitchShifter<float>::Mode::QUALITY, "quality", f);
+        pass &= checkOctaveDown(giml::PitchShifter<float>::Mode::LOW_LATENCY, "low latency", f);
+    }
+    return pass ? 0 : 1;
+}